@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/declarations.h"
+
+// Замеры производительности: ядра кривых, методы интегрирования и все
+// RootFinder на фиксированных нагрузках. Каждый замер - BENCH_WARMUP
+// прогонов вхолостую и BENCH_REPEATS замеренных; печатаются медиана и
+// медианное абсолютное отклонение (MAD) времени на одну операцию.
+// Вывод - по строке JSON на замер (--csv - CSV с заголовком)
+
+#define BENCH_WARMUP 3
+#define BENCH_REPEATS 15
+#define BENCH_KERNEL_POINTS 100000
+#define BENCH_INTEGRAL_EPS 1e-6
+#define BENCH_ROOT_EPS 1e-6
+
+typedef struct {
+    const char* name;
+    const char* unit;
+    void (*run)(void* ctx);
+    void* ctx;
+    long operations;       // Операций за один прогон
+} Benchmark;
+
+// Результат прогона, который нельзя выбросить оптимизатору
+static volatile double sink;
+static bool csv_output = false;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compare_doubles(const void* x, const void* y) {
+    double a = *(const double*)x;
+    double b = *(const double*)y;
+    return (a > b) - (a < b);
+}
+
+static double median(double* values, int n) {
+    qsort(values, (size_t)n, sizeof(double), compare_doubles);
+    return (n % 2) ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+static void print_header(void) {
+    if (csv_output) {
+        printf("name,unit,median,mad,repeats,evals_per_op\n");
+    }
+}
+
+static void report(const Benchmark* b, double med, double mad, double evals_per_op) {
+    if (csv_output) {
+        printf("%s,%s,%.3f,%.3f,%d,%.2f\n", b->name, b->unit, med, mad, BENCH_REPEATS, evals_per_op);
+    } else {
+        printf("{\"name\": \"%s\", \"unit\": \"%s\", \"median\": %.3f, \"mad\": %.3f, "
+               "\"repeats\": %d, \"evals_per_op\": %.2f}\n",
+               b->name, b->unit, med, mad, BENCH_REPEATS, evals_per_op);
+    }
+    fflush(stdout);
+}
+
+// evals - счетчик вызовов кривых за прогон (NULL - не считается)
+static void run_benchmark(const Benchmark* b, long* evals) {
+    double samples[BENCH_REPEATS];
+
+    for (int i = 0; i < BENCH_WARMUP; i++) {
+        b->run(b->ctx);
+    }
+
+    long calls = 0;
+    for (int i = 0; i < BENCH_REPEATS; i++) {
+        if (evals) *evals = 0;
+
+        double start = now_ns();
+        b->run(b->ctx);
+        samples[i] = (now_ns() - start) / b->operations;
+
+        if (evals) calls = *evals;
+    }
+
+    double med = median(samples, BENCH_REPEATS);
+    for (int i = 0; i < BENCH_REPEATS; i++) {
+        double d = samples[i] - med;
+        samples[i] = d < 0 ? -d : d;
+    }
+    double mad = median(samples, BENCH_REPEATS);
+
+    report(b, med, mad, evals ? (double)calls / b->operations : 1.0);
+}
+
+// Ядра кривых: прямой вызов afunc на равномерной сетке [-2, 2]
+static void run_kernel(void* ctx) {
+    afunc f = *(afunc*)ctx;
+    double sum = 0.0;
+    for (int i = 0; i < BENCH_KERNEL_POINTS; i++) {
+        sum += f(-2.0 + 4.0 * i / BENCH_KERNEL_POINTS);
+    }
+    sink = sum;
+}
+
+// Интегрирование: f1 на [0, 1]
+typedef struct {
+    Integrator* integ;
+    Function* f;
+} IntegralWork;
+
+static void run_integral(void* ctx) {
+    IntegralWork* work = (IntegralWork*)ctx;
+    sink = work->integ->integrate(work->f, 0.0, 1.0, BENCH_INTEGRAL_EPS);
+}
+
+// Поиск корней: три точки пересечения фигуры
+typedef struct {
+    RootFinder* rf;
+    Figure* fig;
+} RootWork;
+
+static void run_roots(void* ctx) {
+    RootWork* work = (RootWork*)ctx;
+    double points[3];
+    int count = 0;
+    find_intersection_points(work->fig, BENCH_ROOT_EPS, work->rf, points, &count);
+    sink = points[0];
+}
+
+static void bench_kernels(void) {
+    afunc kernels[] = { f1, f2, f3, df1, df2, df3, ddf1, ddf2, ddf3 };
+    const char* names[] = { "kernel/f1", "kernel/f2", "kernel/f3", "kernel/df1", "kernel/df2", "kernel/df3",
+                            "kernel/ddf1", "kernel/ddf2", "kernel/ddf3" };
+
+    for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+        Benchmark b = { names[i], "ns/eval", run_kernel, &kernels[i], BENCH_KERNEL_POINTS };
+        run_benchmark(&b, NULL);
+    }
+}
+
+static void bench_integrators(void) {
+    Function base = create_function_with_ddf(f1, df1, ddf1, "f1");
+    char name[64];
+
+    // Все методы реестра, включая auto: замер тот же, что и у --integrator
+    for (int i = 0; i < integrator_registry_size; i++) {
+        Integrator method = integrator_registry[i].create();
+        CallCounter counter;
+        long calls = 0;
+        Function f = create_counted_function(&counter, &base, &calls);
+        IntegralWork work = { &method, &f };
+
+        snprintf(name, sizeof(name), "integrate/%s", integrator_registry[i].key);
+        Benchmark b = { name, "ns/integral", run_integral, &work, 1 };
+        run_benchmark(&b, &calls);
+    }
+}
+
+// Счетчик общий на три кривые фигуры: evals_per_op - вызовов на корень
+// (значения и первые производные)
+static void bench_root_finders(void) {
+    Function curves[3] = {
+        create_function_with_ddf(f1, df1, ddf1, "f1"),
+        create_function_with_ddf(f2, df2, ddf2, "f2"),
+        create_function_with_ddf(f3, df3, ddf3, "f3")
+    };
+    char name[64];
+
+    for (int i = 0; i < root_finder_registry_size; i++) {
+        RootFinder method = root_finder_registry[i].create();
+        CallCounter counters[3];
+        Function counted[3];
+        long calls = 0;
+        for (int k = 0; k < 3; k++) {
+            counted[k] = create_counted_function(&counters[k], &curves[k], &calls);
+        }
+        Figure fig = create_figure(counted[0], counted[1], counted[2], 0.0, 2.0);
+
+        RootWork work = { &method, &fig };
+        snprintf(name, sizeof(name), "roots/%s", root_finder_registry[i].key);
+        Benchmark b = { name, "ns/root", run_roots, &work, 3 };
+        run_benchmark(&b, &calls);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv_output = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--csv]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    print_header();
+    bench_kernels();
+    bench_integrators();
+    bench_root_finders();
+    return EXIT_SUCCESS;
+}
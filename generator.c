@@ -15,6 +15,35 @@
 double constants[MAX_CONSTANTS];
 int const_count = 0;
 
+// Целевая архитектура. Тело функции в обоих случаях считается на x87;
+// различаются соглашение о вызовах и адресация констант
+typedef struct {
+    const char* name;       // Значение третьего аргумента (ARCH в Makefile)
+    const char* header;     // Директивы в начале файла
+    const char* prologue;   // Пролог функции
+    const char* variable;   // Операнд с аргументом x
+    const char* epilogue;   // Эпилог: результат из st0 туда, где его ждет вызывающий
+    const char* footer;
+} TargetArch;
+
+static const TargetArch targets[] = {
+    // cdecl: x на стеке, результат в st0
+    { "i386", "",
+      "    push ebp\n    mov ebp, esp\n",
+      "qword [ebp + 8]",
+      "    pop ebp\n    ret\n\n",
+      "" },
+    // System V AMD64: x в xmm0, результат в xmm0; x хранится в кадре,
+    // константы адресуются относительно rip (для PIE)
+    { "x86_64", "default rel\n\n",
+      "    push rbp\n    mov rbp, rsp\n    sub rsp, 16\n    movsd [rbp - 8], xmm0\n",
+      "qword [rbp - 8]",
+      "    fstp qword [rbp - 8]\n    movsd xmm0, [rbp - 8]\n    leave\n    ret\n\n",
+      "section .note.GNU-stack noalloc noexec nowrite progbits\n" }
+};
+
+static const TargetArch* target = &targets[0];
+
 // Прототипы функций
 static int add_constant(double value);
 static Node* build_ast_from_rpn(const char *rpn);
@@ -147,7 +176,7 @@ static void generate_node_asm_code(FILE *fp, Node* node) {
         }
         
         case NODE_VARIABLE:
-            fprintf(fp, "    fld qword [ebp + 8]\n");
+            fprintf(fp, "    fld %s\n", target->variable);
             break;
             
         case NODE_BINARY_OP:
@@ -238,15 +267,13 @@ static void generate_node_asm_code(FILE *fp, Node* node) {
 // Генерация полного ассемблерного кода для функции
 static void generate_function_asm_code(FILE *fp, Node* ast, const char* func_name) {
     fprintf(fp, "%s:\n", func_name);
-    fprintf(fp, "    push ebp\n");
-    fprintf(fp, "    mov ebp, esp\n");
+    fputs(target->prologue, fp);
     
     // Генерируем код для вычисления выражения
     generate_node_asm_code(fp, ast);
     
     // Завершаем функцию
-    fprintf(fp, "    pop ebp\n");
-    fprintf(fp, "    ret\n\n");
+    fputs(target->epilogue, fp);
 }
 
 // Генерация ассемблерного кода для всех функций
@@ -260,6 +287,11 @@ static void generate_asm_code(FILE *fp, Node* f1_ast, Node* f2_ast, Node* f3_ast
     Node* df2_ast = derive_ast(f2_ast);
     Node* df3_ast = derive_ast(f3_ast);
     
+    // Вторые производные - производные от уже построенных производных
+    Node* ddf1_ast = derive_ast(df1_ast);
+    Node* ddf2_ast = derive_ast(df2_ast);
+    Node* ddf3_ast = derive_ast(df3_ast);
+    
     // Создаем временный файл для сбора констант
     FILE* temp_fp = tmpfile();
     if (!temp_fp) {
@@ -267,6 +299,9 @@ static void generate_asm_code(FILE *fp, Node* f1_ast, Node* f2_ast, Node* f3_ast
         free_ast(df1_ast);
         free_ast(df2_ast);
         free_ast(df3_ast);
+        free_ast(ddf1_ast);
+        free_ast(ddf2_ast);
+        free_ast(ddf3_ast);
         exit(EXIT_FAILURE);
     }
     
@@ -277,12 +312,16 @@ static void generate_asm_code(FILE *fp, Node* f1_ast, Node* f2_ast, Node* f3_ast
     generate_node_asm_code(temp_fp, df1_ast);
     generate_node_asm_code(temp_fp, df2_ast);
     generate_node_asm_code(temp_fp, df3_ast);
+    generate_node_asm_code(temp_fp, ddf1_ast);
+    generate_node_asm_code(temp_fp, ddf2_ast);
+    generate_node_asm_code(temp_fp, ddf3_ast);
     
     fclose(temp_fp);
     
     // Теперь все константы собраны, можно генерировать реальный файл
     
     // Начало файла
+    fputs(target->header, fp);
     fprintf(fp, "section .data\n");
     
     // Генерируем константы
@@ -297,7 +336,10 @@ static void generate_asm_code(FILE *fp, Node* f1_ast, Node* f2_ast, Node* f3_ast
     fprintf(fp, "    global f3\n");
     fprintf(fp, "    global df1\n");
     fprintf(fp, "    global df2\n");
-    fprintf(fp, "    global df3\n\n");
+    fprintf(fp, "    global df3\n");
+    fprintf(fp, "    global ddf1\n");
+    fprintf(fp, "    global ddf2\n");
+    fprintf(fp, "    global ddf3\n\n");
     
     // Генерируем код для функций
     generate_function_asm_code(fp, f1_ast, "f1");
@@ -309,10 +351,20 @@ static void generate_asm_code(FILE *fp, Node* f1_ast, Node* f2_ast, Node* f3_ast
     generate_function_asm_code(fp, df2_ast, "df2");
     generate_function_asm_code(fp, df3_ast, "df3");
     
+    // Вторые производные (нужны методу Галлея)
+    generate_function_asm_code(fp, ddf1_ast, "ddf1");
+    generate_function_asm_code(fp, ddf2_ast, "ddf2");
+    generate_function_asm_code(fp, ddf3_ast, "ddf3");
+    
+    fputs(target->footer, fp);
+    
     // Освобождаем память
     free_ast(df1_ast);
     free_ast(df2_ast);
     free_ast(df3_ast);
+    free_ast(ddf1_ast);
+    free_ast(ddf2_ast);
+    free_ast(ddf3_ast);
 }
 
 // Вспомогательная функция для отладки лексера
@@ -336,11 +388,24 @@ static void generate_asm_code(FILE *fp, Node* f1_ast, Node* f2_ast, Node* f3_ast
 // }
 
 int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s <input_file> <output_file>\n", argv[0]);
+    if (argc != 3 && argc != 4) {
+        fprintf(stderr, "Usage: %s <input_file> <output_file> [i386|x86_64]\n", argv[0]);
         return EXIT_FAILURE;
     }
     
+    if (argc == 4) {
+        target = NULL;
+        for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+            if (strcmp(argv[3], targets[i].name) == 0) {
+                target = &targets[i];
+            }
+        }
+        if (!target) {
+            fprintf(stderr, "Error: Unknown target architecture %s\n", argv[3]);
+            return EXIT_FAILURE;
+        }
+    }
+    
     FILE *input_fp = fopen(argv[1], "r");
     if (!input_fp) {
         fprintf(stderr, "Error: Could not open input file %s\n", argv[1]);
@@ -7,6 +7,13 @@
 
 #include "src/declarations.h"
 #include "src/cli/cmdline.h"
+#include "src/batch/batch.h"
+#include "src/server/server.h"
+#include "src/cache/cache.h"
+#include "src/profile/profile.h"
+#include "src/trace/trace.h"
+#include "src/spec/spec.h"
+#include "src/plugin/plugin.h"
 
 extern double f1(double x);
 extern double f2(double x);
@@ -14,38 +21,90 @@ extern double f3(double x);
 extern double df1(double x);
 extern double df2(double x);
 extern double df3(double x);
+extern double ddf1(double x);
+extern double ddf2(double x);
+extern double ddf3(double x);
 
-// Вспомогательная функция для разности функций (для интегрирования)
-// Для использования в function_difference в Calculate_area
-typedef struct {
-    Function* upper;
-    Function* lower;
-} FunctionPair;
-
-static FunctionPair* function_pair = NULL;
-
-// Устанавливает функции для вычисления разности
-void set_difference_functions(Function* upper, Function* lower) {
-    if (!function_pair) {
-        function_pair = (FunctionPair*)malloc(sizeof(FunctionPair));
-        if (!function_pair) {
-            fprintf(stderr, "Memory allocation failed for FunctionPair\n");
-            exit(EXIT_FAILURE);
-        }
-    }
-    
-    function_pair->upper = upper;
-    function_pair->lower = lower;
+// Набор ядер f1..f3, с которым собрана программа. integral_generated
+// получает контрольную сумму своего ассемблера: файл --cache обычной
+// сборки ему не подходит, хотя имена кривых совпадают
+#ifndef CURVE_SET
+#define CURVE_SET "builtin"
+#endif
+
+// Составные функции над парой кривых. Состояние хранится в FunctionPair
+// у вызывающего кода и передается через ctx, глобальных данных нет
+
+static double difference_value(void* ctx, double x) {
+    FunctionPair* pair = (FunctionPair*)ctx;
+    return evaluate(pair->upper, x) - evaluate(pair->lower, x);
 }
 
-// Функция для вычисления разности
-double function_difference(double x) {
-    if (!function_pair) {
-        fprintf(stderr, "Error: function_pair not initialized\n");
-        exit(EXIT_FAILURE);
-    }
-    
-    return evaluate(function_pair->upper, x) - evaluate(function_pair->lower, x);
+static double difference_derivative(void* ctx, double x) {
+    FunctionPair* pair = (FunctionPair*)ctx;
+    return evaluate_derivative(pair->upper, x) - evaluate_derivative(pair->lower, x);
+}
+
+static double abs_difference_value(void* ctx, double x) {
+    return fabs(difference_value(ctx, x));
+}
+
+static double abs_difference_derivative(void* ctx, double x) {
+    double d = difference_derivative(ctx, x);
+    return (difference_value(ctx, x) < 0) ? -d : d;
+}
+
+static double max_value(void* ctx, double x) {
+    FunctionPair* pair = (FunctionPair*)ctx;
+    return fmax(evaluate(pair->upper, x), evaluate(pair->lower, x));
+}
+
+static double max_derivative(void* ctx, double x) {
+    FunctionPair* pair = (FunctionPair*)ctx;
+    return (evaluate(pair->upper, x) >= evaluate(pair->lower, x))
+        ? evaluate_derivative(pair->upper, x)
+        : evaluate_derivative(pair->lower, x);
+}
+
+static double min_value(void* ctx, double x) {
+    FunctionPair* pair = (FunctionPair*)ctx;
+    return fmin(evaluate(pair->upper, x), evaluate(pair->lower, x));
+}
+
+static double min_derivative(void* ctx, double x) {
+    FunctionPair* pair = (FunctionPair*)ctx;
+    return (evaluate(pair->upper, x) <= evaluate(pair->lower, x))
+        ? evaluate_derivative(pair->upper, x)
+        : evaluate_derivative(pair->lower, x);
+}
+
+// Функция-обертка для Function с контекстом
+Function create_context_function(cfunc f, cfunc df, void* ctx, const char* name) {
+    Function func = create_function(NULL, NULL, name);
+    func.ctx_function = f;
+    func.ctx_derivative = df;
+    func.ctx = ctx;
+    return func;
+}
+
+// upper - lower
+Function create_difference_function(FunctionPair* pair) {
+    return create_context_function(difference_value, difference_derivative, pair, "difference");
+}
+
+// |upper - lower|
+Function create_abs_difference_function(FunctionPair* pair) {
+    return create_context_function(abs_difference_value, abs_difference_derivative, pair, "abs difference");
+}
+
+// max(upper, lower)
+Function create_max_function(FunctionPair* pair) {
+    return create_context_function(max_value, max_derivative, pair, "max");
+}
+
+// min(upper, lower)
+Function create_min_function(FunctionPair* pair) {
+    return create_context_function(min_value, min_derivative, pair, "min");
 }
 
 // Реализация root для удовлетворения требований задания
@@ -59,6 +118,8 @@ double root(afunc f, afunc g, afunc df, afunc dg, double a, double b, double eps
     
 #ifdef USE_BISECTION
     rf = create_bisection_method();
+#elif defined(USE_HALLEY)
+    rf = create_halley_method();
 #else
     rf = create_combined_method();
 #endif
@@ -83,18 +144,52 @@ Function create_function(afunc f, afunc df, const char* name) {
     Function func;
     func.function = f;
     func.derivative = df;
+    func.second_derivative = NULL;
+    func.batch = NULL;
+    func.ctx_function = NULL;
+    func.ctx_derivative = NULL;
+    func.ctx = NULL;
     func.name = (char*)name; // Предполагаем, что name - статическая строка
+    func.calls = 0;
+    func.derivative_calls = 0;
+    return func;
+}
+
+// Функция-обертка для Function со второй производной
+Function create_function_with_ddf(afunc f, afunc df, afunc ddf, const char* name) {
+    Function func = create_function(f, df, name);
+    func.second_derivative = ddf;
     return func;
 }
 
 // Вычисление значения функции
 double evaluate(Function* f, double x) {
-    return f->function(x);
+    PROFILE_COUNT(f->calls, 1);
+    return f->ctx_function ? f->ctx_function(f->ctx, x) : f->function(x);
 }
 
 // Вычисление значения производной
 double evaluate_derivative(Function* f, double x) {
-    return f->derivative(x);
+    PROFILE_COUNT(f->derivative_calls, 1);
+    return f->ctx_derivative ? f->ctx_derivative(f->ctx, x) : f->derivative(x);
+}
+
+// Вычисление значения второй производной (0, если она не задана)
+double evaluate_second_derivative(Function* f, double x) {
+    return f->second_derivative ? f->second_derivative(x) : 0.0;
+}
+
+// Вычисление значений сразу для массива точек
+void evaluate_batch(Function* f, const double* x, double* y, size_t n) {
+    if (f->batch) {
+        PROFILE_COUNT(f->calls, n);
+        f->batch(x, y, n);
+        return;
+    }
+    
+    for (size_t i = 0; i < n; i++) {
+        y[i] = evaluate(f, x[i]);
+    }
 }
 
 // Создание фигуры
@@ -114,98 +209,356 @@ void find_intersection_points(Figure* fig, double eps1, RootFinder* rf, double*
     find_intersection_points_with_iterations(fig, eps1, rf, points, count, &dummy_iterations);
 }
 
+// Поиск точки пересечения одной пары кривых фигуры с полным итогом решения
+// (итоговый отрезок result->lo, result->hi пригоден для последующего уточнения)
+// pair: 0 - f1 и f2, 1 - f1 и f3, 2 - f2 и f3.
+// Все пары ищутся одинаково, поэтому результат не зависит от порядка кривых:
+// если на [a, b] нет смены знака, разность проверяется левее a в точках
+// -1 и INTERSECTION_SEARCH_LEFT
+void solve_intersection_result(Figure* fig, int pair, double eps1, RootFinder* rf, SolveResult* result) {
+    static const double probes[2] = { -1.0, INTERSECTION_SEARCH_LEFT };
+    
+    Function* f;
+    Function* g;
+    get_pair_functions(fig, pair, &f, &g);
+    
+    // Проверяем знаки разности на границах
+    double f_at_a = evaluate(f, fig->a);
+    double g_at_a = evaluate(g, fig->a);
+    double diff_at_a = f_at_a - g_at_a;
+    double diff_at_b = evaluate(f, fig->b) - evaluate(g, fig->b);
+    
+    // Если знаки разности различны, ищем корень на заданном интервале
+    if (diff_at_a * diff_at_b <= 0) {
+        rf->solve_result(f, g, fig->a, fig->b, eps1, result);
+        return;
+    }
+    
+    // Иначе проверяем, есть ли корень в отрицательной области
+    if (fabs(f_at_a) > 1e-6 && fabs(g_at_a) > 1e-6) {
+        double right = fig->a;
+        double diff_at_right = diff_at_a;
+        
+        for (int i = 0; i < 2; i++) {
+            double test_x = probes[i];
+            if (test_x >= right) continue;
+            
+            double diff_at_test = evaluate(f, test_x) - evaluate(g, test_x);
+            if (diff_at_test * diff_at_right <= 0) {
+                rf->solve_result(f, g, test_x, right, eps1, result);
+                return;
+            }
+            
+            right = test_x;
+            diff_at_right = diff_at_test;
+        }
+    }
+    
+    // Если нет очевидных признаков корня, используем обычный интервал
+    rf->solve_result(f, g, fig->a, fig->b, eps1, result);
+}
+
+// То же, но только корень и число итераций
+double solve_intersection(Figure* fig, int pair, double eps1, RootFinder* rf, int* iterations) {
+    SolveResult result;
+    solve_intersection_result(fig, pair, eps1, rf, &result);
+    *iterations = result.iterations;
+    return result.root;
+}
+
+// Сортировка найденных точек по возрастанию
+void sort_points(double* points, int count) {
+    for (int i = 0; i < count; i++) {
+        for (int j = i + 1; j < count; j++) {
+            if (points[i] > points[j]) {
+                double temp = points[i];
+                points[i] = points[j];
+                points[j] = temp;
+            }
+        }
+    }
+}
+
 // Поиск точек пересечения с сохранением числа итераций
 void find_intersection_points_with_iterations(Figure* fig, double eps1, RootFinder* rf, double* points, int* count, int* iterations) {
     *count = 0;
     *iterations = 0;
     
-    // 1. Пытаемся найти точки пересечения f1 и f2
-    int iters1 = 0;
-    points[*count] = rf->solve(&fig->f1, &fig->f2, fig->a, fig->b, eps1, &iters1);
-    (*count)++;
+    for (int pair = 0; pair < 3; pair++) {
+        int pair_iterations = 0;
+        points[*count] = solve_intersection(fig, pair, eps1, rf, &pair_iterations);
+        (*count)++;
+        
+        // Общее число итераций
+        *iterations += pair_iterations;
+    }
     
-    // 2. Пытаемся найти точки пересечения f1 и f3
-    int iters2 = 0;
+    // Сортируем точки
+    sort_points(points, *count);
+}
+
+// Кривые, образующие пару pair (в том же порядке, что и в solve_intersection)
+void get_pair_functions(Figure* fig, int pair, Function** f, Function** g) {
+    Function* curves[3] = { &fig->f1, &fig->f2, &fig->f3 };
+    static const int pair_curves[3][2] = { {0, 1}, {0, 2}, {1, 2} };
     
-    // Проверяем знаки функций на границах для f1 и f3
-    double f1_at_a = evaluate(&fig->f1, fig->a);
-    double f3_at_a = evaluate(&fig->f3, fig->a);
-    double f1_diff_f3_at_a = f1_at_a - f3_at_a;
+    *f = curves[pair_curves[pair][0]];
+    *g = curves[pair_curves[pair][1]];
+}
+
+// Поиск точек пересечения с "теплым стартом" от решений предыдущей задачи.
+// Для каждой пары берется та из prior точек внутри области поиска, где разность
+// кривых меньше всего; вокруг нее открывается малый отрезок, который расширяется
+// в WARM_START_GROWTH раз, пока на нем нет смены знака. Отрезок обрезается по
+// области поиска, и расширение прекращается, когда он покрыл ее целиком.
+// Каждое расширение учитывается как итерация. Если отрезок найти не удалось
+// или решатель не сошелся, пара решается обычным способом
+void find_intersection_points_warm(Figure* fig, double eps1, RootFinder* rf, const double* prior, int prior_count,
+                                   double* points, int* count, int* iterations) {
+    *count = 0;
+    *iterations = 0;
     
-    double f1_at_b = evaluate(&fig->f1, fig->b);
-    double f3_at_b = evaluate(&fig->f3, fig->b);
-    double f1_diff_f3_at_b = f1_at_b - f3_at_b;
+    double range_lo = fmin(INTERSECTION_SEARCH_LEFT, fig->a);
+    double range_hi = fig->b;
     
-    // Если знаки разности различны, ищем корень на заданном интервале
-    if (f1_diff_f3_at_a * f1_diff_f3_at_b <= 0) {
-        points[*count] = rf->solve(&fig->f1, &fig->f3, fig->a, fig->b, eps1, &iters2);
-    } 
-    // Иначе проверяем, есть ли корень в отрицательной области
-    else if (fabs(f1_at_a) > 1e-6 && fabs(f3_at_a) > 1e-6) {
-        // Пробуем найти корень на расширенном интервале, но только если он есть
-        // Проверяем точку -1.0
-        double test_x = -1.0;
-        double f1_at_test = evaluate(&fig->f1, test_x);
-        double f3_at_test = evaluate(&fig->f3, test_x);
+    for (int pair = 0; pair < 3; pair++) {
+        Function* f;
+        Function* g;
+        get_pair_functions(fig, pair, &f, &g);
         
-        if ((f1_at_test - f3_at_test) * f1_diff_f3_at_a <= 0) {
-            // Ищем корень между test_x и fig->a
-            points[*count] = rf->solve(&fig->f1, &fig->f3, test_x, fig->a, eps1, &iters2);
-        } 
-        else {
-            // Ищем корень в более отрицательной области
-            double extended_a = -4.0;
-            double f1_at_extended = evaluate(&fig->f1, extended_a);
-            double f3_at_extended = evaluate(&fig->f3, extended_a);
+        // Ближайшее к корню этой пары предыдущее решение
+        int best = -1;
+        double best_residual = 0.0;
+        for (int i = 0; i < prior_count; i++) {
+            if (prior[i] < range_lo || prior[i] > range_hi) continue;
             
-            if ((f1_at_extended - f3_at_extended) * (f1_at_test - f3_at_test) <= 0) {
-                points[*count] = rf->solve(&fig->f1, &fig->f3, extended_a, test_x, eps1, &iters2);
-            } else {
-                // Корень не найден, берем обычный интервал
-                points[*count] = rf->solve(&fig->f1, &fig->f3, fig->a, fig->b, eps1, &iters2);
+            double residual = fabs(evaluate(f, prior[i]) - evaluate(g, prior[i]));
+            if (best < 0 || residual < best_residual) {
+                best = i;
+                best_residual = residual;
             }
         }
-    } else {
-        // Если нет очевидных признаков корня, используем обычный интервал
-        points[*count] = rf->solve(&fig->f1, &fig->f3, fig->a, fig->b, eps1, &iters2);
+        
+        int pair_iterations = 0;
+        int probes = 0;
+        int found = 0;
+        double radius = WARM_START_RADIUS;
+        
+        while (best >= 0 && probes < WARM_START_MAX_STEPS) {
+            double lo = fmax(prior[best] - radius, range_lo);
+            double hi = fmin(prior[best] + radius, range_hi);
+            double h_lo = evaluate(f, lo) - evaluate(g, lo);
+            double h_hi = evaluate(f, hi) - evaluate(g, hi);
+            probes++;
+            
+            if (h_lo * h_hi <= 0) {
+                SolveResult result;
+                rf->solve_result(f, g, lo, hi, eps1, &result);
+                pair_iterations = result.iterations;
+                if (result.status == SOLVE_CONVERGED) {
+                    points[*count] = result.root;
+                    found = 1;
+                }
+                break;
+            }
+            
+            // Вся область поиска без смены знака: расширять дальше некуда
+            if (lo <= range_lo && hi >= range_hi) break;
+            
+            radius *= WARM_START_GROWTH;
+        }
+        
+        if (!found) {
+            int cold_iterations = 0;
+            points[*count] = solve_intersection(fig, pair, eps1, rf, &cold_iterations);
+            pair_iterations += cold_iterations;
+        }
+        
+        (*count)++;
+        *iterations += pair_iterations + probes;
     }
     
-    (*count)++;
+    sort_points(points, *count);
+}
+
+// Верхняя (максимальная) и нижняя (минимальная) кривые фигуры в точке x_mid
+void select_segment_bounds(Figure* fig, double x_mid, FunctionPair* pair) {
+    double f1_val = evaluate(&fig->f1, x_mid);
+    double f2_val = evaluate(&fig->f2, x_mid);
+    double f3_val = evaluate(&fig->f3, x_mid);
     
-    // 3. Пытаемся найти точки пересечения f2 и f3
-    int iters3 = 0;
-    points[*count] = rf->solve(&fig->f2, &fig->f3, fig->a, fig->b, eps1, &iters3);
-    (*count)++;
+    // Находим верхнюю (максимальную) и нижнюю (минимальную) функции
+    double max_val = f1_val;
+    double min_val = f1_val;
+    pair->upper = &fig->f1;
+    pair->lower = &fig->f1;
+
+    // Проверяем f2
+    if (f2_val > max_val) {
+        max_val = f2_val;
+        pair->upper = &fig->f2;
+    }
+    if (f2_val < min_val) {
+        min_val = f2_val;
+        pair->lower = &fig->f2;
+    }
+
+    // Проверяем f3
+    if (f3_val > max_val) {
+        pair->upper = &fig->f3;
+    }
+    if (f3_val < min_val) {
+        pair->lower = &fig->f3;
+    }
+}
+
+// Бюджеты ошибки площади: на каждую точку пересечения и на каждый сегмент
+void split_area_tolerance(double eps, double* eps_root, double* eps2) {
+    if (!(eps > 0)) eps = AREA_DEFAULT_EPS;
+    *eps_root = eps * AREA_ROOT_SHARE / 3;
+    *eps2 = eps * (1.0 - AREA_ROOT_SHARE) / 2;
+}
+
+// Грубая точность первого прохода: δ при J = 0 и |J'| = 1
+double area_coarse_eps(double eps_root) {
+    return sqrt(2.0 * eps_root);
+}
+
+// Разность верхней и нижней кривых сегмента с серединой mid и ее производная в точке x
+static void segment_integrand(Figure* fig, double mid, double x, double* value, double* slope) {
+    FunctionPair pair;
+    select_segment_bounds(fig, mid, &pair);
+    *value = evaluate(pair.upper, x) - evaluate(pair.lower, x);
+    *slope = evaluate_derivative(pair.upper, x) - evaluate_derivative(pair.lower, x);
+}
+
+// Модули скачка J подынтегральной функции на корне x и его производной J'.
+// points - корни всех пар по возрастанию
+static void root_jump(Figure* fig, const double* points, double x, double* jump, double* jump_slope) {
+    int index = 0;
+    while (index < 2 && points[index] < x) index++;
     
-    // Общее число итераций
-    *iterations = iters1 + iters2 + iters3;
+    double value, slope;
+    *jump = 0.0;
+    *jump_slope = 0.0;
+    if (index > 0) {
+        segment_integrand(fig, (points[index - 1] + x) / 2, x, &value, &slope);
+        *jump += value;
+        *jump_slope += slope;
+    }
+    if (index < 2) {
+        segment_integrand(fig, (x + points[index + 1]) / 2, x, &value, &slope);
+        *jump -= value;
+        *jump_slope -= slope;
+    }
+    *jump = fabs(*jump);
+    *jump_slope = fabs(*jump_slope);
+}
+
+// Уточнение точки пересечения пары pair до ошибки площади не больше eps_root.
+// points - грубые корни всех пар по возрастанию, result - грубое решение пары.
+// Сдвиг корня на δ переносит границу сегментов, и площадь меняется на
+// интеграл скачка J подынтегральной функции на корне (слева минус справа,
+// вне фигуры она равна нулю): |J| δ + |J'| δ² / 2 <= eps_root.
+// Во внутренней точке кривые пересекаются и J = 0, на краю J - высота фигуры.
+// Решатель останавливается по |f - g| < eps1 или по ширине отрезка < eps1,
+// поэтому eps1 = min(δ, |f' - g'| δ). Уточнение идет внутри итогового
+// отрезка грубого решения
+void refine_area_root(Figure* fig, int pair, const double* points, double eps_root, RootFinder* rf,
+                      SolveResult* result) {
+    if (result->status != SOLVE_CONVERGED) {
+        return;
+    }
     
-    // Сортируем точки
-    for (int i = 0; i < *count; i++) {
-        for (int j = i + 1; j < *count; j++) {
-            if (points[i] > points[j]) {
-                double temp = points[i];
-                points[i] = points[j];
-                points[j] = temp;
-            }
+    double x = result->root;
+    double jump, jump_slope;
+    root_jump(fig, points, x, &jump, &jump_slope);
+    
+    // Корень квадратного уравнения в устойчивой форме
+    double delta = 2.0 * eps_root / (jump + sqrt(jump * jump + 2.0 * jump_slope * eps_root));
+    
+    Function* f;
+    Function* g;
+    get_pair_functions(fig, pair, &f, &g);
+    double crossing = fabs(evaluate_derivative(f, x) - evaluate_derivative(g, x));
+    if (crossing < AREA_MIN_SLOPE) crossing = AREA_MIN_SLOPE;
+    
+    double eps1 = (crossing < 1.0) ? crossing * delta : delta;
+    if (!(eps1 < area_coarse_eps(eps_root))) {
+        return;
+    }
+    
+    int iterations = result->iterations;
+    SolveResult refined;
+    rf->solve_result(f, g, result->lo, result->hi, eps1, &refined);
+    if (refined.status == SOLVE_CONVERGED) {
+        *result = refined;
+    } else {
+        solve_intersection_result(fig, pair, eps1, rf, result);
+    }
+    result->iterations += iterations;
+}
+
+// Вклад положения найденного корня пары pair в ошибку площади:
+// |J| δ + |J'| δ² / 2. δ - сдвиг до истинного корня: не больше ширины
+// итогового отрезка решения и, по первому порядку, невязки |f - g| / |f' - g'|
+// (решатель мог остановиться по невязке, не сузив отрезок)
+double area_root_error(Figure* fig, int pair, const double* points, const SolveResult* result) {
+    double x = result->root;
+    double jump, jump_slope;
+    root_jump(fig, points, x, &jump, &jump_slope);
+    
+    Function* f;
+    Function* g;
+    get_pair_functions(fig, pair, &f, &g);
+    double crossing = fabs(evaluate_derivative(f, x) - evaluate_derivative(g, x));
+    if (crossing < AREA_MIN_SLOPE) crossing = AREA_MIN_SLOPE;
+    
+    double delta = fmin(result->hi - result->lo, fabs(evaluate(f, x) - evaluate(g, x)) / crossing);
+    return jump * delta + jump_slope * delta * delta / 2;
+}
+
+// Все три точки пересечения найдены. Иначе сегменты фигуры не определены:
+// печатается причина, и площадь считается ошибкой (-1)
+bool area_roots_converged(const SolveResult* roots) {
+    static const char* reasons[] = { "converged", "empty interval", "no sign change", "iteration limit" };
+    
+    for (int pair = 0; pair < 3; pair++) {
+        if (roots[pair].status != SOLVE_CONVERGED) {
+            fprintf(stderr, "Error: Intersection %d of the figure not found (%s)\n", pair + 1,
+                    reasons[roots[pair].status]);
+            return false;
         }
     }
+    return true;
 }
 
-// Вычисление площади фигуры
-// Величины ε₁ и ε₂ подобраны на основе математического анализа погрешностей
-// ε₁ = 0.00001 для точного определения границ интегрирования
-// ε₂ = 0.00017 для обеспечения точности интегрирования
+// Вычисление площади фигуры с точностью eps, -1 - точки пересечения не найдены
 double calculate_area(Figure* fig, double eps, RootFinder* rf, Integrator* integ) {
-    // Находим точки пересечения с точностью ε₁
-    double intersection_points[3]; // Максимум 3 точки пересечения
-    int count = 0;
+    // Делим допуск eps между корнями (ε₁ по каждой паре) и квадратурой (ε₂)
+    double eps_root, eps2;
+    split_area_tolerance(eps, &eps_root, &eps2);
+    
+    double intersection_points[3]; // Ровно 3 точки пересечения
+    
+    // Грубые корни задают сегменты, по ним каждый корень уточняется до своего ε₁
+    PROFILE_START(roots_start);
+    SolveResult roots[3];
+    double coarse[3];
+    for (int pair = 0; pair < 3; pair++) {
+        solve_intersection_result(fig, pair, area_coarse_eps(eps_root), rf, &roots[pair]);
+        coarse[pair] = roots[pair].root;
+    }
+    sort_points(coarse, 3);
     
-    double eps1 = 0.000001;  // Выбрано на основе анализа погрешностей
-    find_intersection_points(fig, eps1, rf, intersection_points, &count);
+    for (int pair = 0; pair < 3; pair++) {
+        refine_area_root(fig, pair, coarse, eps_root, rf, &roots[pair]);
+        intersection_points[pair] = roots[pair].root;
+    }
+    sort_points(intersection_points, 3);
+    PROFILE_STOP(PROFILE_ROOTS, roots_start);
     
-    if (count < 2) {
-        fprintf(stderr, "Error: Failed to find enough intersection points\n");
+    if (!area_roots_converged(roots)) {
         return -1.0;
     }
     
@@ -213,54 +566,24 @@ double calculate_area(Figure* fig, double eps, RootFinder* rf, Integrator* integ
     double area = 0.0;
     
     // Перебираем каждый сегмент между точками пересечения
-    for (int i = 0; i < count - 1; i++) {
+    for (int i = 0; i < 2; i++) {
         double a = intersection_points[i];
         double b = intersection_points[i + 1];
         
         // Определяем, какие функции формируют верхнюю и нижнюю границы на этом интервале
-        double x_mid = (a + b) / 2;
-        double f1_val = evaluate(&fig->f1, x_mid);
-        double f2_val = evaluate(&fig->f2, x_mid);
-        double f3_val = evaluate(&fig->f3, x_mid);
-        
-        // Находим верхнюю (максимальную) и нижнюю (минимальную) функции
-        double max_val = f1_val;
-        double min_val = f1_val;
-        Function* upper = &fig->f1;
-        Function* lower = &fig->f1;
-
-        // Проверяем f2
-        if (f2_val > max_val) {
-            max_val = f2_val;
-            upper = &fig->f2;
-        }
-        if (f2_val < min_val) {
-            min_val = f2_val;
-            lower = &fig->f2;
-        }
-
-        // Проверяем f3
-        if (f3_val > max_val) {
-            max_val = f3_val;
-            upper = &fig->f3;
-        }
-        if (f3_val < min_val) {
-            min_val = f3_val;
-            lower = &fig->f3;
-        }
+        FunctionPair pair;
+        PROFILE_START(bounds_start);
+        select_segment_bounds(fig, (a + b) / 2, &pair);
+        PROFILE_STOP(PROFILE_BOUNDS, bounds_start);
         
         // Создаем функцию разности для интегрирования
-        Function diff;
-        diff.function = function_difference;
-        diff.derivative = NULL; // Не нужно для интегрирования
-        diff.name = "difference";
-        
-        // Устанавливаем функции для разности
-        set_difference_functions(upper, lower);
+        Function diff = create_difference_function(&pair);
+        PairIntegral special = lookup_specialized_simpson(integ, pair.upper, pair.lower);
         
         // Вычисляем интеграл с точностью ε₂
-        double eps2 = 0.000001;  // Выбрано на основе анализа погрешностей
-        double segment_area = integ->integrate(&diff, a, b, eps2);
+        PROFILE_START(integration_start);
+        double segment_area = special ? special(a, b, eps2) : integ->integrate(&diff, a, b, eps2);
+        PROFILE_STOP(PROFILE_INTEGRATION, integration_start);
         
         area += segment_area;
     }
@@ -268,25 +591,58 @@ double calculate_area(Figure* fig, double eps, RootFinder* rf, Integrator* integ
     return area;
 }
 
+static const Function* lookup_curves = NULL;
+
+void set_lookup_curves(const Function* curves) {
+    lookup_curves = curves;
+}
+
+// Кривые по номеру, как в --test-root и пакетном режиме: 1..3 - встроенные
+// (или из --spec), с PLUGIN_FIRST_CURVE - из плагинов
+bool lookup_curve(int id, Function* out) {
+    if (id >= PLUGIN_FIRST_CURVE) {
+        return plugin_lookup_curve(id - PLUGIN_FIRST_CURVE, out);
+    }
+    
+    if (lookup_curves && id >= 1 && id <= 3) {
+        *out = lookup_curves[id - 1];
+        return true;
+    }
+    
+    switch (id) {
+        case 1:
+            *out = create_function_with_ddf(f1, df1, ddf1, "f1");
+            return true;
+        case 2:
+            *out = create_function_with_ddf(f2, df2, ddf2, "f2");
+            return true;
+        case 3:
+            *out = create_function_with_ddf(f3, df3, ddf3, "f3");
+            return true;
+        default:
+            return false;
+    }
+}
+
 // Тестирование функции root
-void test_root(RootFinder* rf, int f1_idx, int f2_idx, double a, double b, double eps, double expected) {
+void test_root(ResultCache* cache, RootFinder* rf, int f1_idx, int f2_idx, double a, double b, double eps,
+               double expected) {
     // Получаем соответствующие функции
-    Function functions[3];
-    functions[0] = create_function(f1, df1, "f1");
-    functions[1] = create_function(f2, df2, "f2");
-    functions[2] = create_function(f3, df3, "f3");
+    Function functions[2];
     
-    if (f1_idx < 1 || f1_idx > 3 || f2_idx < 1 || f2_idx > 3) {
+    if (!lookup_curve(f1_idx, &functions[0]) || !lookup_curve(f2_idx, &functions[1])) {
         printf("Error: Invalid function indices\n");
         return;
     }
     
-    Function* func1 = &functions[f1_idx - 1];
-    Function* func2 = &functions[f2_idx - 1];
+    Function* func1 = &functions[0];
+    Function* func2 = &functions[1];
     
-    // Выполняем поиск корня
-    int iterations = 0;
-    double result = rf->solve(func1, func2, a, b, eps, &iterations);
+    // Выполняем поиск корня, предупреждения решателя печатаем здесь
+    SolveResult solve_result;
+    cache_solve_root(cache, func1, func2, a, b, eps, rf, &solve_result);
+    print_solve_status(stdout, &solve_result);
+    double result = solve_result.root;
     
     // Вычисляем ошибки
     double abs_error = fabs(result - expected);
@@ -297,22 +653,20 @@ void test_root(RootFinder* rf, int f1_idx, int f2_idx, double a, double b, doubl
 }
 
 // Тестирование функции integral
-void test_integral(Integrator* integ, int f_idx, double a, double b, double eps, double expected) {
+void test_integral(ResultCache* cache, Integrator* integ, int f_idx, double a, double b, double eps,
+                   double expected) {
     // Получаем соответствующую функцию
-    Function functions[3];
-    functions[0] = create_function(f1, df1, "f1");
-    functions[1] = create_function(f2, df2, "f2");
-    functions[2] = create_function(f3, df3, "f3");
+    Function function;
     
-    if (f_idx < 1 || f_idx > 3) {
+    if (!lookup_curve(f_idx, &function)) {
         printf("Error: Invalid function index\n");
         return;
     }
     
-    Function* func = &functions[f_idx - 1];
+    Function* func = &function;
     
     // Выполняем интегрирование
-    double result = integ->integrate(func, a, b, eps);
+    double result = cache_integrate(cache, func, a, b, eps, integ);
     
     // Вычисляем ошибки
     double abs_error = fabs(result - expected);
@@ -322,52 +676,131 @@ void test_integral(Integrator* integ, int f_idx, double a, double b, double eps,
     printf("%.5f %.5f %.7f\n", result, abs_error, rel_error);
 }
 
-// Прототип функции cleanup
-void cleanup(void);
+// INTEGRAL_LIBRARY - сборка без main для bench/ и других программ
+#ifndef INTEGRAL_LIBRARY
+// Вывод промежуточных оценок для --progressive
+static bool print_estimate(const AreaEstimate* estimate, void* ctx) {
+    (void)ctx;
+    printf("Step %d: area = %.10f +- %.3e (%d evaluations, %.3f ms)\n", estimate->step,
+           estimate->area, estimate->error, estimate->evaluations, estimate->elapsed_ms);
+    fflush(stdout);
+    return true;
+}
 
-// Освобождение ресурсов
-void cleanup(void) {
-    if (function_pair) {
-        free(function_pair);
-        function_pair = NULL;
+// Таблица опций живет вне main: кадр main и так близок к -Wstack-usage
+#define CLI_OPTION_COUNT 25
+
+static Option options[CLI_OPTION_COUNT];
+
+static int create_cli_options(void) {
+    int count = 0;
+    options[count++] = create_option('h', "help", "Show this help message", false);
+    options[count++] = create_option('r', "root", "Print intersection points", false);
+    options[count++] = create_option('i', "iterations", "Print iteration counts for root finding", false);
+    options[count++] = create_option('R', "test-root", "Test root function (format: F1:F2:A:B:E:R)", true);
+    options[count++] = create_option('I', "test-integral", "Test integral function (format: F:A:B:E:R)", true);
+    options[count++] = create_option('c', "chebyshev", "Calculate area using Chebyshev proxies of the curves", false);
+    options[count++] = create_option('w', "warm-start", "Start root finding from previous roots (format: X1,X2,X3)", true);
+    options[count++] = create_option('t', "threads", "Calculate area on N threads (format: N)", true);
+    options[count++] = create_option('b', "batch", "Calculate areas for jobs \"F1 F2 F3 A B EPS\" from FILE or - (stdin)", true);
+    options[count++] = create_option('s', "serve", "Serve area/roots/integral requests on Unix socket PATH (workers: --threads)", true);
+    options[count++] = create_option('C', "cache", "Keep computed results in FILE between runs", true);
+    options[count++] = create_option('p', "progressive", "Print refined area estimates with error bounds as they improve", false);
+    options[count++] = create_option('d', "deadline", "Stop progressive refinement after MS milliseconds", true);
+    options[count++] = create_option('e', "refine", "Recompute area for each eps in turn reusing previous work (format: eps1,eps2,...)", true);
+    options[count++] = create_option('E', "envelope", "Area between upper and lower envelopes of curves on [-4, 2] (format: 1,2,3)", true);
+    options[count++] = create_option('m', "method", "Area method: qmc (quasi-Monte Carlo with confidence interval)", true);
+    options[count++] = create_option('n', "samples", "Number of points for --method qmc (format: N)", true);
+    options[count++] = create_option('P', "profile", "Print curve call counts and calculate_area phase times (make profile)", false);
+    options[count++] = create_option('T', "trace", "Write solver iterates and Simpson levels to CSV FILE (see make trace_summary)", true);
+    options[count++] = create_option('M', "root-method", "Root finder: combined, bisection, halley or auto (overrides build default)", true);
+    options[count++] = create_option('g', "integrator", "Integrator: simpson, adaptive or auto (overrides build default)", true);
+    options[count++] = create_option('x', "compare", "Compare every root finder x integrator pair against a reference area", false);
+    options[count++] = create_option('S', "spec", "Use curves and range from spec FILE, built once into the spec cache", true);
+    options[count++] = create_option('D', "spec-cache", "Spec cache directory (default $XDG_CACHE_HOME/"
+                                                        SPEC_CACHE_DEFAULT_NAME " or ~/.cache/" SPEC_CACHE_DEFAULT_NAME ")", true);
+    options[count++] = create_option('L', "plugin", "Load curves from plugin shared object PATH as curves 4, 5, ... (repeatable)", true);
+    return count;
+}
+
+// Плагины загружаются один раз и остаются в памяти на все задания
+static bool load_plugins(const CommandLineOptions* opts) {
+    for (int i = 0; i < opts->plugin_count; i++) {
+        if (!plugin_load(opts->plugin_paths[i])) {
+            plugin_unload_all();
+            return false;
+        }
     }
+    if (opts->plugin_count > 0) {
+        plugin_print_curves(stderr);
+    }
+    return true;
 }
 
 int main(int argc, char *argv[]) {
-    // Регистрируем функцию для освобождения ресурсов
-    atexit(cleanup);
-    
     // Создаем опции командной строки
-    Option options[] = {
-        create_option('h', "help", "Show this help message", false),
-        create_option('r', "root", "Print intersection points", false),
-        create_option('i', "iterations", "Print iteration counts for root finding", false),
-        create_option('R', "test-root", "Test root function (format: F1:F2:A:B:E:R)", true),
-        create_option('I', "test-integral", "Test integral function (format: F:A:B:E:R)", true)
-    };
-    
-    const int count_of_options = sizeof(options) / sizeof(options[0]);
+    const int count_of_options = create_cli_options();
     
     // Разбираем аргументы командной строки
     CommandLineOptions opts = parse_args(argc, argv, options, count_of_options);
     
     // Создаем функции
-    Function func1 = create_function(f1, df1, "f1");
-    Function func2 = create_function(f2, df2, "f2");
-    Function func3 = create_function(f3, df3, "f3");
+    Function func1 = create_function_with_ddf(f1, df1, ddf1, "f1");
+    Function func2 = create_function_with_ddf(f2, df2, ddf2, "f2");
+    Function func3 = create_function_with_ddf(f3, df3, ddf3, "f3");
     
     // Создаем методы решения
     RootFinder rf;
     
+    // В пакетном режиме stdout занят ответами
+    FILE* log_out = (opts.batch || opts.serve) ? stderr : stdout;
+    
+    // Метод по умолчанию задается при сборке, --root-method и --integrator его заменяют
+    const char* rf_banner;
+    
 #ifdef USE_BISECTION
     rf = create_bisection_method();
-    printf("Using Bisection method for root finding\n");
+    rf_banner = "Bisection";
+#elif defined(USE_HALLEY)
+    rf = create_halley_method();
+    rf_banner = "Halley";
 #else
     rf = create_combined_method();
-    printf("Using Combined method for root finding\n");
+    rf_banner = "Combined";
 #endif
     
-    Integrator integ = create_simpson_method();
+    Integrator integ;
+    
+#ifdef USE_ADAPTIVE
+    integ = create_adaptive_simpson_method();
+#else
+    integ = create_simpson_method();
+#endif
+    
+    if (opts.root_method) {
+        if (!create_root_finder_by_name(opts.root_method, &rf)) {
+            fprintf(stderr, "Error: Unknown root method %s (available:", opts.root_method);
+            for (int i = 0; i < root_finder_registry_size; i++) {
+                fprintf(stderr, " %s", root_finder_registry[i].key);
+            }
+            fprintf(stderr, ")\n");
+            return EXIT_FAILURE;
+        }
+        rf_banner = rf.name;
+    }
+    
+    if (opts.integrator) {
+        if (!create_integrator_by_name(opts.integrator, &integ)) {
+            fprintf(stderr, "Error: Unknown integrator %s (available:", opts.integrator);
+            for (int i = 0; i < integrator_registry_size; i++) {
+                fprintf(stderr, " %s", integrator_registry[i].key);
+            }
+            fprintf(stderr, ")\n");
+            return EXIT_FAILURE;
+        }
+    }
+    
+    fprintf(log_out, "Using %s method for root finding\n", rf_banner);
     
     // Создаем фигуру
     // Отрезок [a, b] = [0, 2] определен на основе математического анализа функций
@@ -376,8 +809,31 @@ int main(int argc, char *argv[]) {
     // лежат на отрезке [0, 2]
     double a = 0.0;
     double b = 2.0;
+    
+    // Спецификация заменяет встроенные кривые и отрезок (и кривые 1..3 в пакетном режиме)
+    static SpecLibrary spec;   // Кривые ссылаются на имена внутри, не на стеке main
+    if (opts.spec_path) {
+        if (!spec_load(opts.spec_path, opts.spec_cache_dir, &spec)) {
+            free_command_line_options(&opts);
+            free_options(options, count_of_options);
+            return EXIT_FAILURE;
+        }
+        func1 = spec.curves[0];
+        func2 = spec.curves[1];
+        func3 = spec.curves[2];
+        a = spec.a;
+        b = spec.b;
+        set_lookup_curves(spec.curves);
+    }
+    
     Figure fig = create_figure(func1, func2, func3, a, b);
     
+    if (!load_plugins(&opts)) {
+        free_command_line_options(&opts);
+        free_options(options, count_of_options);
+        return EXIT_FAILURE;
+    }
+    
     // Обрабатываем опции
     if (opts.help) {
         print_help(options, count_of_options);
@@ -386,12 +842,56 @@ int main(int argc, char *argv[]) {
         return EXIT_SUCCESS;
     }
     
-    if (opts.test_root) {
+    // Предыдущие решения для теплого старта
+    double prior_roots[MAX_WARM_START_ROOTS];
+    int prior_count = 0;
+    
+    if (opts.warm_start &&
+        !parse_warm_start_params(opts.warm_start_params, prior_roots, MAX_WARM_START_ROOTS, &prior_count)) {
+        fprintf(stderr, "Error: Invalid warm start roots format\n");
+        return EXIT_FAILURE;
+    }
+    
+    if (opts.trace_path && !trace_open(opts.trace_path, TRACE_DEFAULT_CAPACITY)) {
+        free_command_line_options(&opts);
+        free_options(options, count_of_options);
+        return EXIT_FAILURE;
+    }
+    
+    // Долгоживущие режимы держат кэш в памяти всегда, остальные - только с --cache
+    ResultCache* cache = (opts.serve || opts.batch || opts.cache_path)
+        ? cache_create(CACHE_DEFAULT_CAPACITY, opts.cache_path, CURVE_SET)
+        : NULL;
+    
+    // Интерполянты Чебышева (-c) общие для всех запросов площади процесса:
+    // --refine и --batch строят их один раз на кривую и отрезок.
+    // Записи кэша по килобайту - не на стеке main
+    static ChebyshevCache proxies;
+    
+    if (opts.serve) {
+        if (run_server(opts.serve_path, opts.threads, &rf, &integ, cache) != 0) {
+            cache_destroy(cache);
+            free_command_line_options(&opts);
+            free_options(options, count_of_options);
+            return EXIT_FAILURE;
+        }
+    } else if (opts.batch) {
+        long jobs = run_batch(opts.batch_path, &rf, &integ, cache, opts.use_chebyshev ? &proxies : NULL, stdout);
+        if (jobs < 0) {
+            fprintf(stderr, "Error: Could not read batch input %s\n", opts.batch_path);
+            cache_destroy(cache);
+            free_command_line_options(&opts);
+            free_options(options, count_of_options);
+            return EXIT_FAILURE;
+        }
+    } else if (opts.compare) {
+        compare_methods(&fig, stdout);
+    } else if (opts.test_root) {
         int f1_idx, f2_idx;
         double a, b, eps, expected;
         
         if (parse_test_root_params(opts.test_root_params, &f1_idx, &f2_idx, &a, &b, &eps, &expected)) {
-            test_root(&rf, f1_idx, f2_idx, a, b, eps, expected);
+            test_root(cache, &rf, f1_idx, f2_idx, a, b, eps, expected);
         } else {
             fprintf(stderr, "Error: Invalid test root parameters format\n");
             return EXIT_FAILURE;
@@ -401,7 +901,7 @@ int main(int argc, char *argv[]) {
         double a, b, eps, expected;
         
         if (parse_test_integral_params(opts.test_integral_params, &f_idx, &a, &b, &eps, &expected)) {
-            test_integral(&integ, f_idx, a, b, eps, expected);
+            test_integral(cache, &integ, f_idx, a, b, eps, expected);
         } else {
             fprintf(stderr, "Error: Invalid test integral parameters format\n");
             return EXIT_FAILURE;
@@ -410,7 +910,13 @@ int main(int argc, char *argv[]) {
         double intersection_points[3];
         int count = 0;
         
-        find_intersection_points(&fig, 0.0001, &rf, intersection_points, &count);
+        if (opts.warm_start) {
+            int iterations = 0;
+            find_intersection_points_warm(&fig, 0.0001, &rf, prior_roots, prior_count,
+                                          intersection_points, &count, &iterations);
+        } else {
+            find_intersection_points(&fig, 0.0001, &rf, intersection_points, &count);
+        }
         
         printf("Found %d intersection points:\n", count);
         for (int i = 0; i < count; i++) {
@@ -425,24 +931,156 @@ int main(int argc, char *argv[]) {
         int count = 0;
         int iterations = 0;
         
-        find_intersection_points_with_iterations(&fig, 0.0001, &rf, intersection_points, &count, &iterations);
+        if (opts.warm_start) {
+            find_intersection_points_warm(&fig, 0.0001, &rf, prior_roots, prior_count,
+                                          intersection_points, &count, &iterations);
+        } else {
+            find_intersection_points_with_iterations(&fig, 0.0001, &rf, intersection_points, &count, &iterations);
+        }
         
         printf("Found %d intersection points with %d total iterations:\n", count, iterations);
         for (int i = 0; i < count; i++) {
             printf("Point %d: x = %.6f\n", i+1, intersection_points[i]);
         }
+    } else if (opts.progressive) {
+        // С ограничением по времени уточняем до срока, иначе - до точности по умолчанию
+        double eps = (opts.deadline_ms > 0) ? 0.0 : AREA_DEFAULT_EPS;
+        AreaEstimate estimate = calculate_area_progressive(&fig, eps, opts.deadline_ms, &rf, print_estimate, NULL);
+        if (estimate.area < 0) {
+            return EXIT_FAILURE;
+        }
+        printf("Area of the figure: %.6f\n", estimate.area);
+    } else if (opts.refine) {
+        double eps_steps[MAX_REFINE_STEPS];
+        int steps = 0;
+        
+        if (!parse_double_list(opts.refine_params, eps_steps, MAX_REFINE_STEPS, &steps)) {
+            fprintf(stderr, "Error: Invalid refine eps list format\n");
+            return EXIT_FAILURE;
+        }
+        
+        AreaSession session;
+        area_session_init(&session, &fig, &rf);
+        
+        // Площадь по интерполянтам не зависит от eps (их точность -
+        // CHEB_TAIL_TOLERANCE): кривые вызываются только на первом шаге
+        for (int i = 0; opts.use_chebyshev && i < steps; i++) {
+            unsigned long evaluations_before = proxies.evaluations;
+            double area = chebyshev_calculate_area(&proxies, &fig, INTERSECTION_SEARCH_LEFT, b);
+            if (area < 0) {
+                fprintf(stderr, "Error: Could not calculate the area of the figure\n");
+                return EXIT_FAILURE;
+            }
+            printf("eps = %g: area = %.10f (Chebyshev proxies, %lu evaluations)\n", eps_steps[i], area,
+                   proxies.evaluations - evaluations_before);
+        }
+        
+        for (int i = 0; !opts.use_chebyshev && i < steps; i++) {
+            int iterations_before = session.root_iterations;
+            int evaluations_before = session.evaluations;
+            double area = area_session_area(&session, eps_steps[i]);
+            if (area < 0) {
+                fprintf(stderr, "Error: Could not calculate the area of the figure\n");
+                return EXIT_FAILURE;
+            }
+            printf("eps = %g: area = %.10f (%d root iterations, %d evaluations)\n", eps_steps[i], area,
+                   session.root_iterations - iterations_before, session.evaluations - evaluations_before);
+        }
+    } else if (opts.envelope) {
+        int ids[ENVELOPE_MAX_CURVES];
+        int n = 0;
+        
+        if (!parse_int_list(opts.envelope_params, ids, ENVELOPE_MAX_CURVES, &n)) {
+            fprintf(stderr, "Error: Invalid envelope curve list format\n");
+            return EXIT_FAILURE;
+        }
+        
+        Function* curves = (Function*)malloc(n * sizeof(Function));
+        if (!curves) {
+            fprintf(stderr, "Memory allocation failed for envelope curves\n");
+            return EXIT_FAILURE;
+        }
+        for (int i = 0; i < n; i++) {
+            if (!lookup_curve(ids[i], &curves[i])) {
+                fprintf(stderr, "Error: Unknown curve %d\n", ids[i]);
+                free(curves);
+                return EXIT_FAILURE;
+            }
+        }
+        
+        // Окно то же, что и у интерполянтов Чебышева
+        double area = calculate_envelope_area(curves, n, INTERSECTION_SEARCH_LEFT, b, 0.000001, &rf, &integ,
+                                              opts.threads > 0 ? opts.threads : 1);
+        free(curves);
+        if (area < 0) {
+            fprintf(stderr, "Error: Could not calculate the envelope area\n");
+            return EXIT_FAILURE;
+        }
+        printf("Area of the figure: %.6f\n", area);
+    } else if (opts.method) {
+        if (strcmp(opts.method, "qmc") != 0) {
+            fprintf(stderr, "Error: Unknown area method %s\n", opts.method);
+            return EXIT_FAILURE;
+        }
+        
+        long samples = (opts.samples > 0) ? opts.samples : QMC_DEFAULT_SAMPLES;
+        QmcEstimate estimate = calculate_area_qmc(&fig, &rf, samples, opts.threads, 1);
+        printf("Area of the figure: %.6f +- %.6f (95%% CI, %ld samples, %.0f samples/s)\n",
+               estimate.area, estimate.half_width, estimate.samples, estimate.samples / estimate.seconds);
+    } else if (opts.use_chebyshev) {
+        // Интерполянты строятся на отрезке, где find_intersection_points ищет корни
+        double area = chebyshev_calculate_area(&proxies, &fig, INTERSECTION_SEARCH_LEFT, b);
+        if (area < 0) {
+            fprintf(stderr, "Error: Could not calculate the area of the figure\n");
+            return EXIT_FAILURE;
+        }
+        printf("Chebyshev degrees: f1 = %d, f2 = %d, f3 = %d (%lu evaluations)\n",
+               chebyshev_cache_proxy(&proxies, &fig.f1, INTERSECTION_SEARCH_LEFT, b)->degree,
+               chebyshev_cache_proxy(&proxies, &fig.f2, INTERSECTION_SEARCH_LEFT, b)->degree,
+               chebyshev_cache_proxy(&proxies, &fig.f3, INTERSECTION_SEARCH_LEFT, b)->degree,
+               proxies.evaluations);
+        printf("Area of the figure: %.6f\n", area);
     } else {
         // Вычисляем площадь фигуры с заданной точностью
         double eps = 0.001;
         printf("Calculating area with epsilon = %.6f\n", eps);
-        double area = calculate_area(&fig, eps, &rf, &integ);
+        double area = (opts.threads > 0)
+            ? calculate_area_parallel(&fig, eps, &rf, &integ, opts.threads)
+            : cache_calculate_area(cache, &fig, eps, &rf, &integ);
         
+        if (area < 0) {
+            fprintf(stderr, "Error: Could not calculate the area of the figure\n");
+            return EXIT_FAILURE;
+        }
         printf("Area of the figure: %.6f\n", area);
     }
     
+    if (opts.profile) {
+        profile_print(stderr, &fig);
+    }
+    
+    trace_close();
+    
+    if (cache) {
+        uint64_t hits, misses;
+        uint32_t entries;
+        cache_stats(cache, &hits, &misses, &entries);
+        fprintf(stderr, "Cache: %llu hits, %llu misses, %u entries\n",
+                (unsigned long long)hits, (unsigned long long)misses, (unsigned)entries);
+        cache_destroy(cache);
+    }
+    
+    plugin_unload_all();
+    
+    if (opts.spec_path) {
+        set_lookup_curves(NULL);
+        spec_unload(&spec);
+    }
+    
     // Освобождаем память
     free_command_line_options(&opts);
     free_options(options, count_of_options);
     
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
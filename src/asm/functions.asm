@@ -8,6 +8,7 @@ section .rodata
     const_1 dq 1.0
     const_3 dq 3.0
     const_5 dq 5.0
+    const_20 dq 20.0
 
     const_ln2 dq 0.693147180559945  ; ln(2)
     const_minus_1_div_3 dq -0.333333333333333  ; -1/3
@@ -19,6 +20,9 @@ section .text
     global df1
     global df2
     global df3
+    global ddf1
+    global ddf2
+    global ddf3
 
 ; --------------------------------------------------------------
 ; f1(x) = 2^x + 1
@@ -170,6 +174,77 @@ df3:
     pop ebp
     ret
 
+; --------------------------------------------------------------
+; ddf1(x) = 2^x * ln(2)^2
+; --------------------------------------------------------------
+
+ddf1:
+    push ebp
+    mov ebp, esp
+    
+    ; Загружаем x
+    fld qword [ebp + 8]
+    
+    ; Вычисляем 2^x (аналогично df1)
+    fld st0            ; Дублируем x: st0=x, st1=x
+    fld st0            ; Еще раз дублируем: st0=x, st1=x, st2=x
+    frndint            ; Округляем до целого: st0=int(x), st1=x, st2=x
+    fxch st1           ; Меняем местами: st0=x, st1=int(x), st2=x
+    fsub st0, st1      ; Вычитаем целую часть: st0=frac(x), st1=int(x), st2=x
+    f2xm1              ; Вычисляем 2^(дробная часть) - 1: st0=2^frac(x)-1, st1=int(x), st2=x
+    fld1               ; Загружаем 1.0: st0=1.0, st1=2^frac(x)-1, st2=int(x), st3=x
+    faddp              ; Складываем с 1: st0=2^frac(x), st1=int(x), st2=x
+    fscale             ; Умножаем на 2^(целая часть): st0=2^x, st1=int(x), st2=x
+    fstp st1           ; Убираем st1, теперь st0=2^x, st1=x
+    fstp st1           ; Убираем st1, теперь st0=2^x
+    
+    ; Дважды умножаем на ln(2)
+    fld qword [const_ln2]
+    fmulp
+    fld qword [const_ln2]
+    fmulp
+    
+    pop ebp
+    ret
+
+; --------------------------------------------------------------
+; ddf2(x) = 20*x^3
+; --------------------------------------------------------------
+ddf2:
+    push ebp
+    mov ebp, esp
+    
+    ; Загружаем x
+    fld qword [ebp + 8]
+    
+    ; Вычисляем x^2
+    fld st0
+    fmulp       ; st0 = x^2
+    
+    ; Умножаем на x, получаем x^3
+    fld qword [ebp + 8]
+    fmulp       ; st0 = x^3
+    
+    ; Умножаем на 20
+    fld qword [const_20]
+    fmulp       ; st0 = 20*x^3
+    
+    pop ebp
+    ret
+
+; --------------------------------------------------------------
+; ddf3(x) = 0
+; --------------------------------------------------------------
+ddf3:
+    push ebp
+    mov ebp, esp
+    
+    ; Вторая производная линейной функции равна нулю
+    fldz
+    
+    pop ebp
+    ret
+
 ;Эта функция вычисляет 2^x + 1:
 
 ;Стандартный пролог функции
@@ -0,0 +1,141 @@
+; x86-64 (System V AMD64) версии ядер из functions.asm
+; f1(x) = 2^x + 1
+; f2(x) = x^5
+; f3(x) = (1-x)/3
+;
+; Аргумент приходит в xmm0, результат возвращается в xmm0.
+; Многочлены и дроби считаются на SSE2, 2^x - на x87 (f2xm1 и fscale),
+; как в 32-битной версии: x и результат проходят через красную зону под rsp
+
+default rel
+
+section .rodata
+    ; consts data
+
+    const_1 dq 1.0
+    const_3 dq 3.0
+    const_5 dq 5.0
+    const_20 dq 20.0
+
+    const_ln2 dq 0.693147180559945  ; ln(2)
+    const_minus_1_div_3 dq -0.333333333333333  ; -1/3
+
+section .text
+    global f1
+    global f2
+    global f3
+    global df1
+    global df2
+    global df3
+    global ddf1
+    global ddf2
+    global ddf3
+
+; 2^x из xmm0 в st0 (та же последовательность, что в functions.asm)
+%macro POW2_X87 0
+    movsd [rsp - 8], xmm0
+    fld qword [rsp - 8]
+    fld st0            ; st0=x, st1=x
+    fld st0            ; st0=x, st1=x, st2=x
+    frndint            ; st0=int(x), st1=x, st2=x
+    fxch st1           ; st0=x, st1=int(x), st2=x
+    fsub st0, st1      ; st0=frac(x), st1=int(x), st2=x
+    f2xm1              ; st0=2^frac(x)-1, st1=int(x), st2=x
+    fld1
+    faddp              ; st0=2^frac(x), st1=int(x), st2=x
+    fscale             ; st0=2^x, st1=int(x), st2=x
+    fstp st1           ; st0=2^x, st1=x
+    fstp st1           ; st0=2^x
+%endmacro
+
+; st0 -> xmm0
+%macro RETURN_X87 0
+    fstp qword [rsp - 8]
+    movsd xmm0, [rsp - 8]
+    ret
+%endmacro
+
+; --------------------------------------------------------------
+; f1(x) = 2^x + 1
+; --------------------------------------------------------------
+f1:
+    POW2_X87
+    fld qword [const_1]
+    faddp
+    RETURN_X87
+
+; --------------------------------------------------------------
+; df1(x) = 2^x * ln(2)
+; --------------------------------------------------------------
+df1:
+    POW2_X87
+    fld qword [const_ln2]
+    fmulp
+    RETURN_X87
+
+; --------------------------------------------------------------
+; ddf1(x) = 2^x * ln(2)^2
+; --------------------------------------------------------------
+ddf1:
+    POW2_X87
+    ; Дважды умножаем на ln(2)
+    fld qword [const_ln2]
+    fmulp
+    fld qword [const_ln2]
+    fmulp
+    RETURN_X87
+
+; --------------------------------------------------------------
+; f2(x) = x^5
+; --------------------------------------------------------------
+f2:
+    movapd xmm1, xmm0   ; xmm1 = x
+    mulsd xmm0, xmm0    ; xmm0 = x^2
+    mulsd xmm0, xmm0    ; xmm0 = x^4
+    mulsd xmm0, xmm1    ; xmm0 = x^5
+    ret
+
+; --------------------------------------------------------------
+; df2(x) = 5*x^4
+; --------------------------------------------------------------
+df2:
+    mulsd xmm0, xmm0    ; xmm0 = x^2
+    mulsd xmm0, xmm0    ; xmm0 = x^4
+    mulsd xmm0, [const_5]
+    ret
+
+; --------------------------------------------------------------
+; ddf2(x) = 20*x^3
+; --------------------------------------------------------------
+ddf2:
+    movapd xmm1, xmm0   ; xmm1 = x
+    mulsd xmm0, xmm0    ; xmm0 = x^2
+    mulsd xmm0, xmm1    ; xmm0 = x^3
+    mulsd xmm0, [const_20]
+    ret
+
+; --------------------------------------------------------------
+; f3(x) = (1-x)/3
+; --------------------------------------------------------------
+f3:
+    movsd xmm1, [const_1]
+    subsd xmm1, xmm0    ; xmm1 = 1-x
+    divsd xmm1, [const_3]
+    movapd xmm0, xmm1
+    ret
+
+; --------------------------------------------------------------
+; df3(x) = -1/3
+; --------------------------------------------------------------
+df3:
+    movsd xmm0, [const_minus_1_div_3]
+    ret
+
+; --------------------------------------------------------------
+; ddf3(x) = 0
+; --------------------------------------------------------------
+ddf3:
+    xorpd xmm0, xmm0
+    ret
+
+section .note.GNU-stack noalloc noexec nowrite progbits
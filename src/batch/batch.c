@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "batch.h"
+
+// Буфер вывода: ответы сбрасываются крупными блоками, а не построчно
+static char output_buffer[1 << 16];
+
+// Разбор одной строки задания без выделения памяти.
+// Возвращает 1 - задание, 0 - пропустить строку, -1 - ошибка формата
+static int parse_job(const char* line, int* ids, double* a, double* b, double* eps) {
+    const char* p = line;
+    char* end = NULL;
+
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p == '\0' || *p == '\n' || *p == '\r' || *p == '#') {
+        return 0;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        ids[i] = (int)strtol(p, &end, 10);
+        if (end == p) return -1;
+        p = end;
+    }
+
+    double* values[3] = { a, b, eps };
+    for (int i = 0; i < 3; i++) {
+        *values[i] = strtod(p, &end);
+        if (end == p) return -1;
+        p = end;
+    }
+
+    // После шести чисел допускаются только пробелы
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    return *p == '\0' ? 1 : -1;
+}
+
+// Обработка одной строки: пишет ответ в out
+static int process_line(const char* line, RootFinder* rf, Integrator* integ, ResultCache* cache,
+                        ChebyshevCache* proxies, FILE* out) {
+    int ids[3];
+    double a, b, eps;
+
+    int parsed = parse_job(line, ids, &a, &b, &eps);
+    if (parsed == 0) {
+        return 0;
+    }
+
+    Function curves[3];
+    // Фигура ограничена тремя разными кривыми
+    if (parsed < 0 || ids[0] == ids[1] || ids[0] == ids[2] || ids[1] == ids[2] ||
+        !lookup_curve(ids[0], &curves[0]) || !lookup_curve(ids[1], &curves[1]) ||
+        !lookup_curve(ids[2], &curves[2]) || !(b > a) || !(eps > 0)) {
+        fputs("error\n", out);
+        return 1;
+    }
+
+    Figure fig = create_figure(curves[0], curves[1], curves[2], a, b);
+    // Интерполянты - на отрезке поиска корней, общие для заданий с теми же кривыми
+    double area = proxies
+        ? chebyshev_calculate_area(proxies, &fig, fmin(INTERSECTION_SEARCH_LEFT, a), b)
+        : cache_calculate_area(cache, &fig, eps, rf, integ);
+    if (area < 0) {
+        fputs("error\n", out);
+    } else {
+        fprintf(out, "%.10f\n", area);
+    }
+    return 1;
+}
+
+// Файл отображается в память целиком, строки копируются в буфер на стеке
+static long run_mapped(int fd, size_t size, RootFinder* rf, Integrator* integ, ResultCache* cache,
+                       ChebyshevCache* proxies, FILE* out) {
+    if (size == 0) {
+        return 0;
+    }
+
+    const char* data = (const char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return -1;
+    }
+    madvise((void*)data, size, MADV_SEQUENTIAL);
+
+    char line[BATCH_MAX_LINE];
+    long jobs = 0;
+    size_t pos = 0;
+
+    while (pos < size) {
+        const char* start = data + pos;
+        const char* newline = (const char*)memchr(start, '\n', size - pos);
+        size_t len = newline ? (size_t)(newline - start) : size - pos;
+        pos += len + 1;
+
+        // Слишком длинная строка - заведомо ошибка формата
+        if (len >= BATCH_MAX_LINE) {
+            fputs("error\n", out);
+            jobs++;
+            continue;
+        }
+
+        memcpy(line, start, len);
+        line[len] = '\0';
+        jobs += process_line(line, rf, integ, cache, proxies, out);
+    }
+
+    munmap((void*)data, size);
+    return jobs;
+}
+
+static long run_stream(FILE* in, RootFinder* rf, Integrator* integ, ResultCache* cache,
+                       ChebyshevCache* proxies, FILE* out) {
+    char line[BATCH_MAX_LINE];
+    long jobs = 0;
+
+    while (fgets(line, sizeof(line), in)) {
+        size_t len = strlen(line);
+
+        // Строка не поместилась в буфер: остаток пропускается, и ответ -
+        // error, как в run_mapped (а не два задания из половинок)
+        if (len == sizeof(line) - 1 && line[len - 1] != '\n') {
+            int c = getc(in);
+            if (c != EOF && c != '\n') {
+                while ((c = getc(in)) != EOF && c != '\n') {}
+                fputs("error\n", out);
+                jobs++;
+                continue;
+            }
+        }
+
+        jobs += process_line(line, rf, integ, cache, proxies, out);
+    }
+
+    return jobs;
+}
+
+long run_batch(const char* path, RootFinder* rf, Integrator* integ, ResultCache* cache,
+               ChebyshevCache* proxies, FILE* out) {
+    setvbuf(out, output_buffer, _IOFBF, sizeof(output_buffer));
+
+    long jobs;
+    if (strcmp(path, "-") == 0) {
+        jobs = run_stream(stdin, rf, integ, cache, proxies, out);
+    } else {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return -1;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return -1;
+        }
+
+        // Не обычный файл (канал, устройство) читаем потоком
+        if (S_ISREG(st.st_mode)) {
+            jobs = run_mapped(fd, (size_t)st.st_size, rf, integ, cache, proxies, out);
+        } else {
+            FILE* in = fdopen(fd, "r");
+            if (!in) {
+                close(fd);
+                return -1;
+            }
+            jobs = run_stream(in, rf, integ, cache, proxies, out);
+            fclose(in);  // Закрывает и fd
+            fd = -1;
+        }
+
+        if (fd >= 0) close(fd);
+    }
+
+    fflush(out);
+    return jobs;
+}
@@ -0,0 +1,23 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "../declarations.h"
+#include "../cache/cache.h"
+
+// Пакетный режим: одна строка задания - "F1 F2 F3 A B EPS" (номера кривых,
+// отрезок поиска корней и точность), одна строка ответа - площадь фигуры.
+// Пустые строки и строки, начинающиеся с '#', пропускаются. Ответ error -
+// ошибка формата (в том числе мусор после EPS и строка длиннее
+// BATCH_MAX_LINE - 1 символов), неизвестная или повторенная кривая
+
+#define BATCH_MAX_LINE 256
+
+// path - имя файла (отображается в память) или "-" для stdin,
+// cache - кэш площадей или NULL. proxies - кэш интерполянтов Чебышева
+// (-c): площадь между всеми пересечениями на [min(INTERSECTION_SEARCH_LEFT, A), B]
+// считается по ним, EPS не используется; NULL - обычный путь.
+// Возвращает число обработанных заданий или -1, если вход не открыт
+long run_batch(const char* path, RootFinder* rf, Integrator* integ, ResultCache* cache,
+               ChebyshevCache* proxies, FILE* out);
+
+#endif
@@ -0,0 +1,443 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cache.h"
+
+#define CACHE_MAGIC 0x31484341u   // "ACH1"
+#define CACHE_FORMAT_VERSION 2
+#define CACHE_FNV_PRIME 0x100000001b3ULL
+
+#if defined(__x86_64__)
+#define CACHE_ARCH "x86_64"
+#elif defined(__i386__)
+#define CACHE_ARCH "i386"
+#else
+#define CACHE_ARCH "unknown"
+#endif
+
+// Все связи - индексы, а не указатели: отображение может оказаться
+// по другому адресу после перезапуска
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_size;  // sizeof(CacheEntry) у записавшей сборки
+    char arch[8];
+    char curves[CACHE_CURVES_LEN];
+    uint32_t capacity;
+    uint32_t buckets;     // Степень двойки, не меньше 2 * capacity
+    uint32_t count;
+    int32_t head;         // Последний использованный
+    int32_t tail;         // Кандидат на вытеснение
+} CacheHeader;
+
+typedef struct {
+    CacheKey key;
+    int32_t prev;
+    int32_t next;
+    CachedResult result;
+} CacheEntry;
+
+struct ResultCache {
+    CacheHeader* header;
+    CacheEntry* entries;
+    int32_t* index;       // Открытая адресация, -1 - пустая ячейка
+    size_t size;
+    int fd;
+    uint64_t hits;
+    uint64_t misses;
+    pthread_mutex_t lock;
+};
+
+uint64_t cache_hash_bytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= CACHE_FNV_PRIME;
+    }
+    return hash;
+}
+
+// Вместе с завершающим нулем, чтобы "f1"+"2" не совпало с "f"+"12"
+uint64_t cache_hash_string(uint64_t hash, const char* s) {
+    if (!s) s = "";
+    return cache_hash_bytes(hash, s, strlen(s) + 1);
+}
+
+uint64_t cache_hash_double(uint64_t hash, double x) {
+    return cache_hash_bytes(hash, &x, sizeof(x));
+}
+
+static void key_bytes(CacheKey* key, const void* data, size_t size) {
+    if (key->length > CACHE_KEY_LEN || size > CACHE_KEY_LEN - key->length) {
+        key->length = CACHE_KEY_LEN + 1;
+        return;
+    }
+    memcpy(key->bytes + key->length, data, size);
+    key->length += (uint32_t)size;
+}
+
+static void key_string(CacheKey* key, const char* s) {
+    if (!s) s = "";
+    key_bytes(key, s, strlen(s) + 1);
+}
+
+static void key_double(CacheKey* key, double x) {
+    key_bytes(key, &x, sizeof(x));
+}
+
+static void key_figure(CacheKey* key, const char* kind, const Figure* fig, double eps) {
+    key->length = 0;
+    key_string(key, kind);
+    key_string(key, fig->f1.name);
+    key_string(key, fig->f2.name);
+    key_string(key, fig->f3.name);
+    key_double(key, fig->a);
+    key_double(key, fig->b);
+    key_double(key, eps);
+}
+
+static void key_finish(CacheKey* key) {
+    key->hash = key->length <= CACHE_KEY_LEN
+        ? cache_hash_bytes(CACHE_HASH_SEED, key->bytes, key->length)
+        : 0;
+}
+
+void cache_area_key(const Figure* fig, double eps, const RootFinder* rf, const Integrator* integ, CacheKey* key) {
+    key_figure(key, "area", fig, eps);
+    key_string(key, rf->name);
+    key_string(key, integ->name);
+    key_finish(key);
+}
+
+void cache_roots_key(const Figure* fig, double eps, const RootFinder* rf, CacheKey* key) {
+    key_figure(key, "roots", fig, eps);
+    key_string(key, rf->name);
+    key_finish(key);
+}
+
+void cache_root_key(const Function* f, const Function* g, double a, double b, double eps, const RootFinder* rf,
+                    CacheKey* key) {
+    key->length = 0;
+    key_string(key, "root");
+    key_string(key, f->name);
+    key_string(key, g->name);
+    key_double(key, a);
+    key_double(key, b);
+    key_double(key, eps);
+    key_string(key, rf->name);
+    key_finish(key);
+}
+
+void cache_integral_key(const Function* f, double a, double b, double eps, const Integrator* integ, CacheKey* key) {
+    key->length = 0;
+    key_string(key, "integral");
+    key_string(key, f->name);
+    key_double(key, a);
+    key_double(key, b);
+    key_double(key, eps);
+    key_string(key, integ->name);
+    key_finish(key);
+}
+
+static bool key_equal(const CacheKey* x, const CacheKey* y) {
+    return x->hash == y->hash && x->length == y->length && memcmp(x->bytes, y->bytes, x->length) == 0;
+}
+
+static uint32_t bucket_count(uint32_t capacity) {
+    uint32_t buckets = 16;
+    while (buckets < 2 * capacity) buckets *= 2;
+    return buckets;
+}
+
+static size_t layout_size(uint32_t capacity) {
+    return sizeof(CacheHeader) + (size_t)capacity * sizeof(CacheEntry) +
+           (size_t)bucket_count(capacity) * sizeof(int32_t);
+}
+
+static void reset_table(ResultCache* cache, uint32_t capacity, const char* curves) {
+    CacheHeader* h = cache->header;
+    h->magic = CACHE_MAGIC;
+    h->version = CACHE_FORMAT_VERSION;
+    h->entry_size = sizeof(CacheEntry);
+    memset(h->arch, 0, sizeof(h->arch));
+    strncpy(h->arch, CACHE_ARCH, sizeof(h->arch) - 1);
+    memset(h->curves, 0, sizeof(h->curves));
+    strncpy(h->curves, curves, sizeof(h->curves) - 1);
+    h->capacity = capacity;
+    h->buckets = bucket_count(capacity);
+    h->count = 0;
+    h->head = -1;
+    h->tail = -1;
+    memset(cache->index, 0xff, (size_t)h->buckets * sizeof(int32_t));
+}
+
+// Отображение файла; при любой ошибке возвращает MAP_FAILED
+static void* map_file(ResultCache* cache, const char* path, size_t size) {
+    cache->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (cache->fd < 0) {
+        perror(path);
+        return MAP_FAILED;
+    }
+
+    // Один файл - один процесс: общей блокировки между процессами у кэша нет
+    if (flock(cache->fd, LOCK_EX | LOCK_NB) != 0) {
+        fprintf(stderr, "Warning: Cache file %s is in use, caching in memory only\n", path);
+        close(cache->fd);
+        cache->fd = -1;
+        return MAP_FAILED;
+    }
+
+    struct stat st;
+    if (fstat(cache->fd, &st) != 0 || ((size_t)st.st_size != size && ftruncate(cache->fd, (off_t)size) != 0)) {
+        perror(path);
+        close(cache->fd);
+        cache->fd = -1;
+        return MAP_FAILED;
+    }
+
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+    if (data == MAP_FAILED) {
+        perror(path);
+        close(cache->fd);
+        cache->fd = -1;
+    }
+    return data;
+}
+
+// Файл другой версии, архитектуры, раскладки, размера или набора ядер
+static bool header_matches(const CacheHeader* h, uint32_t capacity, const char* curves) {
+    return h->magic == CACHE_MAGIC && h->version == CACHE_FORMAT_VERSION &&
+           h->entry_size == sizeof(CacheEntry) &&
+           strncmp(h->arch, CACHE_ARCH, sizeof(h->arch)) == 0 &&
+           strncmp(h->curves, curves, sizeof(h->curves) - 1) == 0 &&
+           h->capacity == capacity && h->buckets == bucket_count(capacity) && h->count <= capacity &&
+           h->head >= -1 && h->head < (int32_t)h->count && h->tail >= -1 && h->tail < (int32_t)h->count;
+}
+
+ResultCache* cache_create(uint32_t capacity, const char* path, const char* curves) {
+    if (capacity < 1) capacity = 1;
+    if (!curves) curves = "";
+
+    ResultCache* cache = (ResultCache*)calloc(1, sizeof(ResultCache));
+    if (!cache) {
+        fprintf(stderr, "Memory allocation failed for ResultCache\n");
+        exit(EXIT_FAILURE);
+    }
+
+    cache->size = layout_size(capacity);
+    cache->fd = -1;
+
+    void* data = path ? map_file(cache, path, cache->size) : MAP_FAILED;
+    if (data == MAP_FAILED) {
+        data = mmap(NULL, cache->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            fprintf(stderr, "Memory allocation failed for ResultCache table\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    cache->header = (CacheHeader*)data;
+    cache->entries = (CacheEntry*)((char*)data + sizeof(CacheHeader));
+    cache->index = (int32_t*)(cache->entries + capacity);
+    pthread_mutex_init(&cache->lock, NULL);
+
+    // Чужой файл начинаем заново
+    if (!header_matches(cache->header, capacity, curves)) {
+        reset_table(cache, capacity, curves);
+    }
+
+    return cache;
+}
+
+void cache_destroy(ResultCache* cache) {
+    if (!cache) return;
+
+    munmap(cache->header, cache->size);
+    if (cache->fd >= 0) close(cache->fd);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+}
+
+// Ячейка индекса с ключом key или пустая ячейка, где он должен быть
+static uint32_t find_slot(ResultCache* cache, const CacheKey* key) {
+    uint32_t mask = cache->header->buckets - 1;
+    uint32_t i = (uint32_t)key->hash & mask;
+
+    while (cache->index[i] >= 0 && !key_equal(&cache->entries[cache->index[i]].key, key)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// Удаление из открытой адресации со сдвигом назад, без "надгробий"
+static void remove_slot(ResultCache* cache, uint32_t i) {
+    uint32_t mask = cache->header->buckets - 1;
+    uint32_t j = i;
+
+    for (;;) {
+        j = (j + 1) & mask;
+        if (cache->index[j] < 0) break;
+
+        uint32_t home = (uint32_t)cache->entries[cache->index[j]].key.hash & mask;
+        // Элемент из j можно перенести в i, если i лежит между home и j
+        bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable) {
+            cache->index[i] = cache->index[j];
+            i = j;
+        }
+    }
+
+    cache->index[i] = -1;
+}
+
+static void list_unlink(ResultCache* cache, int32_t e) {
+    CacheHeader* h = cache->header;
+    CacheEntry* entry = &cache->entries[e];
+
+    if (entry->prev >= 0) cache->entries[entry->prev].next = entry->next;
+    else h->head = entry->next;
+    if (entry->next >= 0) cache->entries[entry->next].prev = entry->prev;
+    else h->tail = entry->prev;
+}
+
+static void list_push_front(ResultCache* cache, int32_t e) {
+    CacheHeader* h = cache->header;
+    CacheEntry* entry = &cache->entries[e];
+
+    entry->prev = -1;
+    entry->next = h->head;
+    if (h->head >= 0) cache->entries[h->head].prev = e;
+    h->head = e;
+    if (h->tail < 0) h->tail = e;
+}
+
+bool cache_get(ResultCache* cache, const CacheKey* key, CachedResult* result) {
+    if (key->length > CACHE_KEY_LEN) return false;
+
+    pthread_mutex_lock(&cache->lock);
+
+    int32_t e = cache->index[find_slot(cache, key)];
+    if (e < 0) {
+        cache->misses++;
+        pthread_mutex_unlock(&cache->lock);
+        return false;
+    }
+
+    if (cache->header->head != e) {
+        list_unlink(cache, e);
+        list_push_front(cache, e);
+    }
+    *result = cache->entries[e].result;
+    cache->hits++;
+
+    pthread_mutex_unlock(&cache->lock);
+    return true;
+}
+
+void cache_put(ResultCache* cache, const CacheKey* key, const CachedResult* result) {
+    if (key->length > CACHE_KEY_LEN) return;
+
+    pthread_mutex_lock(&cache->lock);
+
+    CacheHeader* h = cache->header;
+    uint32_t slot = find_slot(cache, key);
+    int32_t e = cache->index[slot];
+
+    if (e >= 0) {
+        // Уже есть: обновляем значение и поднимаем в начало списка
+        list_unlink(cache, e);
+    } else if (h->count < h->capacity) {
+        e = (int32_t)h->count++;
+        cache->index[slot] = e;
+    } else {
+        // Вытесняем самый старый и занимаем его место в массиве
+        e = h->tail;
+        list_unlink(cache, e);
+        remove_slot(cache, find_slot(cache, &cache->entries[e].key));
+        cache->index[find_slot(cache, key)] = e;
+    }
+
+    cache->entries[e].key = *key;
+    cache->entries[e].result = *result;
+    list_push_front(cache, e);
+
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void cache_stats(ResultCache* cache, uint64_t* hits, uint64_t* misses, uint32_t* entries) {
+    pthread_mutex_lock(&cache->lock);
+    *hits = cache->hits;
+    *misses = cache->misses;
+    *entries = cache->header->count;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+double cache_calculate_area(ResultCache* cache, Figure* fig, double eps, RootFinder* rf, Integrator* integ) {
+    if (!cache) {
+        return calculate_area(fig, eps, rf, integ);
+    }
+
+    CacheKey key;
+    cache_area_key(fig, eps, rf, integ, &key);
+    CachedResult cached;
+    if (cache_get(cache, &key, &cached)) {
+        return cached.values[0];
+    }
+
+    double area = calculate_area(fig, eps, rf, integ);
+    if (area >= 0) {
+        cached.count = 1;
+        cached.values[0] = area;
+        cache_put(cache, &key, &cached);
+    }
+    return area;
+}
+
+void cache_solve_root(ResultCache* cache, Function* f, Function* g, double a, double b, double eps, RootFinder* rf,
+                      SolveResult* result) {
+    if (!cache) {
+        rf->solve_result(f, g, a, b, eps, result);
+        return;
+    }
+
+    CacheKey key;
+    cache_root_key(f, g, a, b, eps, rf, &key);
+    CachedResult cached;
+    if (cache_get(cache, &key, &cached)) {
+        double root = cached.values[0];
+        *result = (SolveResult){ .root = root, .status = SOLVE_CONVERGED, .lo = root, .hi = root };
+        return;
+    }
+
+    rf->solve_result(f, g, a, b, eps, result);
+    if (result->status == SOLVE_CONVERGED && result->flags == 0) {
+        cached.count = 1;
+        cached.values[0] = result->root;
+        cache_put(cache, &key, &cached);
+    }
+}
+
+double cache_integrate(ResultCache* cache, Function* f, double a, double b, double eps, Integrator* integ) {
+    if (!cache) {
+        return integ->integrate(f, a, b, eps);
+    }
+
+    CacheKey key;
+    cache_integral_key(f, a, b, eps, integ, &key);
+    CachedResult cached;
+    if (cache_get(cache, &key, &cached)) {
+        return cached.values[0];
+    }
+
+    cached.count = 1;
+    cached.values[0] = integ->integrate(f, a, b, eps);
+    cache_put(cache, &key, &cached);
+    return cached.values[0];
+}
@@ -0,0 +1,70 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+
+#include "../declarations.h"
+
+// Кэш результатов с вытеснением давно не использованных (LRU).
+// Ключ - имена кривых, методов и битовые образы числовых параметров;
+// запись хранит его целиком, а хэш FNV-1a служит только для поиска.
+// Таблица целиком лежит в одном отображении памяти, поэтому может быть
+// сохранена в файл и пережить перезапуск. Заголовок файла хранит версию
+// формата, архитектуру, размер записи и набор встроенных ядер: имена
+// f1..f3 у сгенерированной сборки те же, поэтому чужой файл начинается заново
+
+#define CACHE_DEFAULT_CAPACITY 4096
+#define CACHE_MAX_VALUES 3
+#define CACHE_KEY_LEN 320         // Имена трех кривых, числа и методы с запасом
+#define CACHE_CURVES_LEN 32
+
+#define CACHE_HASH_SEED 0xcbf29ce484222325ULL
+
+typedef struct ResultCache ResultCache;
+
+typedef struct {
+    int count;
+    double values[CACHE_MAX_VALUES];
+} CachedResult;
+
+// Строки - вместе с завершающим нулем, числа - битовыми образами, поэтому
+// разные наборы полей не склеиваются в одинаковые байты.
+// length > CACHE_KEY_LEN - ключ не поместился, такой запрос не кэшируется
+typedef struct {
+    uint64_t hash;
+    uint32_t length;
+    unsigned char bytes[CACHE_KEY_LEN];
+} CacheKey;
+
+// path = NULL - кэш только в памяти. Если файл не открывается или занят
+// другим процессом, кэш тоже работает только в памяти (с предупреждением).
+// curves - набор встроенных ядер программы (CURVE_SET)
+ResultCache* cache_create(uint32_t capacity, const char* path, const char* curves);
+void cache_destroy(ResultCache* cache);
+
+// Безопасны для вызова из нескольких потоков
+bool cache_get(ResultCache* cache, const CacheKey* key, CachedResult* result);
+void cache_put(ResultCache* cache, const CacheKey* key, const CachedResult* result);
+void cache_stats(ResultCache* cache, uint64_t* hits, uint64_t* misses, uint32_t* entries);
+
+uint64_t cache_hash_bytes(uint64_t hash, const void* data, size_t size);
+uint64_t cache_hash_string(uint64_t hash, const char* s);
+uint64_t cache_hash_double(uint64_t hash, double x);
+
+// Ключи запросов calculate_area, find_intersection_points, solve_result и integrate
+void cache_area_key(const Figure* fig, double eps, const RootFinder* rf, const Integrator* integ, CacheKey* key);
+void cache_roots_key(const Figure* fig, double eps, const RootFinder* rf, CacheKey* key);
+void cache_root_key(const Function* f, const Function* g, double a, double b, double eps, const RootFinder* rf,
+                    CacheKey* key);
+void cache_integral_key(const Function* f, double a, double b, double eps, const Integrator* integ, CacheKey* key);
+
+// calculate_area через кэш (cache = NULL - без кэша). Ошибки не кэшируются
+double cache_calculate_area(ResultCache* cache, Figure* fig, double eps, RootFinder* rf, Integrator* integ);
+// rf->solve_result через кэш. Кэшируются только сошедшиеся решения без
+// предупреждений; из кэша приходит корень с lo = hi = root и 0 итераций
+void cache_solve_root(ResultCache* cache, Function* f, Function* g, double a, double b, double eps, RootFinder* rf,
+                      SolveResult* result);
+// integ->integrate через кэш
+double cache_integrate(ResultCache* cache, Function* f, double a, double b, double eps, Integrator* integ);
+
+#endif
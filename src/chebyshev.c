@@ -0,0 +1,307 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "declarations.h"
+
+// Начальное число узлов и допуск на "хвост" коэффициентов
+#define CHEB_MIN_DEGREE 16
+#define CHEB_TAIL_TOLERANCE 1e-14
+
+// Переход с [a, b] на [-1, 1] и обратно
+static double to_unit(const ChebyshevProxy* p, double x) {
+    return (2.0 * x - p->a - p->b) / (p->b - p->a);
+}
+
+static double from_unit(double a, double b, double t) {
+    return 0.5 * (a + b) + 0.5 * (b - a) * t;
+}
+
+// Комплексное БПФ на месте (основание 2, n - степень двойки)
+static void fft(double* re, double* im, int n) {
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (int len = 2; len <= n; len *= 2) {
+        int half = len / 2;
+        for (int k = 0; k < half; k++) {
+            double w_re = cos(2.0 * M_PI * k / len);
+            double w_im = -sin(2.0 * M_PI * k / len);
+            for (int i = k; i < n; i += len) {
+                double u_re = re[i], u_im = im[i];
+                double v_re = re[i + half] * w_re - im[i + half] * w_im;
+                double v_im = re[i + half] * w_im + im[i + half] * w_re;
+                re[i] = u_re + v_re;
+                im[i] = u_im + v_im;
+                re[i + half] = u_re - v_re;
+                im[i + half] = u_im - v_im;
+            }
+        }
+    }
+}
+
+// Коэффициенты интерполянта по значениям в узлах Чебышева-Лобатто
+// x_j = cos(j*pi/n), n - степень двойки. DCT-I c_k = (2/n) * sum'' f_j * cos(j*k*pi/n)
+// равна Y_k / n, где Y - ДПФ четного продолжения y длины 2n (y_j = y_{2n-j} = f_j).
+// Вещественное ДПФ длины 2n считается через комплексное длины n над
+// z_m = y_{2m} + i y_{2m+1}: Y_k = E_k + e^{-i pi k/n} O_k, где E и O - ДПФ
+// четных и нечетных отсчетов, восстановленные из Z_k и conj(Z_{n-k})
+static void compute_coefficients(ChebyshevProxy* p, const double* samples, int n) {
+    double re[CHEB_MAX_DEGREE];
+    double im[CHEB_MAX_DEGREE];
+
+    for (int m = 0; m < n; m++) {
+        int even = 2 * m;
+        int odd = 2 * m + 1;
+        re[m] = samples[even <= n ? even : 2 * n - even];
+        im[m] = samples[odd <= n ? odd : 2 * n - odd];
+    }
+    fft(re, im, n);
+
+    for (int k = 0; k <= n; k++) {
+        double a = re[k % n], b = im[k % n];
+        double c = re[(n - k) % n], d = im[(n - k) % n];
+        double theta = M_PI * k / n;
+        double y = 0.5 * (a + c) + 0.5 * cos(theta) * (b + d) - 0.5 * sin(theta) * (a - c);
+        p->coeffs[k] = y / n;
+    }
+
+    // Крайние коэффициенты DCT-I входят с весом 1/2
+    p->coeffs[0] *= 0.5;
+    p->coeffs[n] *= 0.5;
+    p->degree = n;
+}
+
+// Построение интерполянта: удваиваем число узлов, пока хвост не станет
+// пренебрежимо мал. Узлы степени n - четные узлы степени 2n, поэтому при
+// удвоении кривая вычисляется только в новых нечетных узлах.
+// Возвращает число вызовов кривой
+int init_chebyshev_proxy(ChebyshevProxy* p, Function* f, double a, double b) {
+    double samples[CHEB_MAX_DEGREE + 1];
+    int evaluations = 0;
+    p->a = a;
+    p->b = b;
+
+    int n = CHEB_MIN_DEGREE;
+    for (int j = 0; j <= n; j++) {
+        samples[j] = evaluate(f, from_unit(a, b, cos(M_PI * j / n)));
+    }
+    evaluations += n + 1;
+
+    bool converged = false;
+    double tail = 0.0;
+    for (;;) {
+        compute_coefficients(p, samples, n);
+
+        double scale = 0.0;
+        for (int k = 0; k <= n; k++) {
+            if (fabs(p->coeffs[k]) > scale) scale = fabs(p->coeffs[k]);
+        }
+
+        tail = fabs(p->coeffs[n]) + fabs(p->coeffs[n - 1]);
+        converged = tail <= CHEB_TAIL_TOLERANCE * (scale > 1.0 ? scale : 1.0);
+        if (converged || 2 * n > CHEB_MAX_DEGREE) break;
+
+        for (int j = n; j >= 0; j--) {
+            samples[2 * j] = samples[j];
+        }
+        n *= 2;
+        for (int j = 1; j < n; j += 2) {
+            samples[j] = evaluate(f, from_unit(a, b, cos(M_PI * j / n)));
+        }
+        evaluations += n / 2;
+    }
+
+    // Интерполянт остается степени CHEB_MAX_DEGREE, но его точность - порядка хвоста
+    if (!converged) {
+        fprintf(stderr, "Warning: Chebyshev coefficients of %s did not converge by degree %d (tail %.3g)\n",
+                f->name ? f->name : "curve", CHEB_MAX_DEGREE, tail);
+    }
+
+    // Отбрасываем нулевой хвост, чтобы последующие запросы были дешевле
+    double scale = fabs(p->coeffs[0]) > 1.0 ? fabs(p->coeffs[0]) : 1.0;
+    while (p->degree > 0 && fabs(p->coeffs[p->degree]) <= CHEB_TAIL_TOLERANCE * scale) {
+        p->degree--;
+    }
+    return evaluations;
+}
+
+// Вычисление значения по схеме Кленшоу
+double chebyshev_evaluate(const ChebyshevProxy* p, double x) {
+    double t = to_unit(p, x);
+    double b1 = 0.0;
+    double b2 = 0.0;
+
+    for (int k = p->degree; k >= 1; k--) {
+        double b0 = 2.0 * t * b1 - b2 + p->coeffs[k];
+        b2 = b1;
+        b1 = b0;
+    }
+
+    return t * b1 - b2 + p->coeffs[0];
+}
+
+// Интеграл по [lo, hi] через коэффициенты первообразной:
+// C_1 = c_0 - c_2/2, C_k = (c_{k-1} - c_{k+1}) / (2k)
+double chebyshev_integrate(const ChebyshevProxy* p, double lo, double hi) {
+    double t_lo = to_unit(p, lo);
+    double t_hi = to_unit(p, hi);
+    int n = p->degree;
+
+    // Сумма C_k * (T_k(t_hi) - T_k(t_lo)), T_k считаем рекуррентно
+    double result = 0.0;
+    double tl_prev = 1.0, tl = t_lo;
+    double th_prev = 1.0, th = t_hi;
+
+    for (int k = 1; k <= n + 1; k++) {
+        double c_prev = p->coeffs[k - 1];
+        double c_next = (k + 1 <= n) ? p->coeffs[k + 1] : 0.0;
+        double ck = (k == 1) ? c_prev - 0.5 * c_next : (c_prev - c_next) / (2.0 * k);
+
+        result += ck * (th - tl);
+
+        double tl_next = 2.0 * t_lo * tl - tl_prev;
+        double th_next = 2.0 * t_hi * th - th_prev;
+        tl_prev = tl;
+        tl = tl_next;
+        th_prev = th;
+        th = th_next;
+    }
+
+    return result * 0.5 * (p->b - p->a);
+}
+
+// Корни разности двух интерполянтов: сетка для отделения корней
+// и рекурсивное деление пополам на самих интерполянтах (без вызовов кривых)
+static double proxy_difference(const ChebyshevProxy* p, const ChebyshevProxy* q, double x) {
+    return chebyshev_evaluate(p, x) - chebyshev_evaluate(q, x);
+}
+
+static double refine_proxy_root(const ChebyshevProxy* p, const ChebyshevProxy* q,
+                                double lo, double hi, double f_lo) {
+    for (int depth = 0; depth < 64 && hi - lo > 1e-15 * (1.0 + fabs(lo)); depth++) {
+        double mid = 0.5 * (lo + hi);
+        double f_mid = proxy_difference(p, q, mid);
+        if ((f_mid < 0.0) == (f_lo < 0.0)) {
+            lo = mid;
+            f_lo = f_mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+int chebyshev_difference_roots(const ChebyshevProxy* p, const ChebyshevProxy* q, double* roots, int max_roots) {
+    int degree = p->degree > q->degree ? p->degree : q->degree;
+    int cells = 4 * (degree + 1);
+    double h = (p->b - p->a) / cells;
+    int count = 0;
+
+    double x_prev = p->a;
+    double f_prev = proxy_difference(p, q, x_prev);
+
+    for (int i = 1; i <= cells && count < max_roots; i++) {
+        double x = (i == cells) ? p->b : p->a + i * h;
+        double fx = proxy_difference(p, q, x);
+
+        if ((fx < 0.0) != (f_prev < 0.0)) {
+            roots[count++] = refine_proxy_root(p, q, x_prev, x, f_prev);
+        }
+
+        x_prev = x;
+        f_prev = fx;
+    }
+
+    return count;
+}
+
+// Одна и та же кривая на том же отрезке: имя кривой уникально в процессе
+// (встроенные, --spec и плагины с хэшем файла)
+static bool same_proxy(const ChebyshevCacheEntry* e, Function* f, double a, double b) {
+    return e->stamp > 0 && f->name && strcmp(e->name, f->name) == 0 &&
+           !(e->proxy.a < a) && !(e->proxy.a > a) && !(e->proxy.b < b) && !(e->proxy.b > b);
+}
+
+// Поиск интерполянта в кэше; при промахе он строится на месте самой давно
+// использованной записи. Запись живет до CHEB_CACHE_SIZE следующих промахов,
+// поэтому три интерполянта одной фигуры не вытесняют друг друга
+const ChebyshevProxy* chebyshev_cache_proxy(ChebyshevCache* cache, Function* f, double a, double b) {
+    int oldest = 0;
+    for (int i = 0; i < CHEB_CACHE_SIZE; i++) {
+        ChebyshevCacheEntry* e = &cache->entries[i];
+        if (same_proxy(e, f, a, b)) {
+            e->stamp = ++cache->clock;
+            cache->hits++;
+            return &e->proxy;
+        }
+        if (e->stamp < cache->entries[oldest].stamp) oldest = i;
+    }
+
+    ChebyshevCacheEntry* e = &cache->entries[oldest];
+    cache->evaluations += init_chebyshev_proxy(&e->proxy, f, a, b);
+    cache->misses++;
+    // Кривая без имени не может совпасть ни с какой другой
+    snprintf(e->name, sizeof(e->name), "%s", f->name ? f->name : "");
+    e->stamp = ++cache->clock;
+    return &e->proxy;
+}
+
+// Площадь по интерполянтам: та же схема, что и в calculate_area,
+// но корни и интегралы берутся напрямую из коэффициентов
+double chebyshev_calculate_area(ChebyshevCache* cache, Figure* fig, double a, double b) {
+    const ChebyshevProxy* proxies[3] = {
+        chebyshev_cache_proxy(cache, &fig->f1, a, b),
+        chebyshev_cache_proxy(cache, &fig->f2, a, b),
+        chebyshev_cache_proxy(cache, &fig->f3, a, b)
+    };
+    double points[3 * CHEB_MAX_ROOTS];
+    int count = 0;
+
+    count += chebyshev_difference_roots(proxies[0], proxies[1], points + count, CHEB_MAX_ROOTS);
+    count += chebyshev_difference_roots(proxies[0], proxies[2], points + count, CHEB_MAX_ROOTS);
+    count += chebyshev_difference_roots(proxies[1], proxies[2], points + count, CHEB_MAX_ROOTS);
+
+    if (count < 2) {
+        return -1.0;
+    }
+
+    // Сортируем точки
+    for (int i = 0; i < count; i++) {
+        for (int j = i + 1; j < count; j++) {
+            if (points[i] > points[j]) {
+                double temp = points[i];
+                points[i] = points[j];
+                points[j] = temp;
+            }
+        }
+    }
+
+    double area = 0.0;
+
+    for (int i = 0; i < count - 1; i++) {
+        double a = points[i];
+        double b = points[i + 1];
+        double x_mid = (a + b) / 2;
+
+        // Верхняя и нижняя функции на сегменте
+        int upper = 0;
+        int lower = 0;
+        for (int k = 1; k < 3; k++) {
+            double value = chebyshev_evaluate(proxies[k], x_mid);
+            if (value > chebyshev_evaluate(proxies[upper], x_mid)) upper = k;
+            if (value < chebyshev_evaluate(proxies[lower], x_mid)) lower = k;
+        }
+
+        area += chebyshev_integrate(proxies[upper], a, b) - chebyshev_integrate(proxies[lower], a, b);
+    }
+
+    return area;
+}
@@ -2,11 +2,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <math.h>
+#include <errno.h>
 #include <getopt.h>
 
 #include <stdbool.h>
 
 #include "cmdline.h"
+#include "../declarations.h"
 
 #define MAX_PARAM_LEN 256
 
@@ -85,6 +88,216 @@ static void handle_test_integral(CommandLineOptions* opts, const char* arg) {
     }
 }
 
+static void handle_chebyshev(CommandLineOptions* opts, const char* arg) {
+    (void)arg; // Не используем аргумент
+    opts->use_chebyshev = true;
+}
+
+static void handle_warm_start(CommandLineOptions* opts, const char* arg) {
+    opts->warm_start = true;
+    if (arg && opts->warm_start_params == NULL) {
+        size_t len = strlen(arg);
+        opts->warm_start_params = (char*)malloc(len + 1);
+        if (opts->warm_start_params) {
+            memcpy(opts->warm_start_params, arg, len);
+            opts->warm_start_params[len] = '\0';
+        }
+    }
+}
+
+// Число потоков - целое от 1 до MAX_THREADS, иначе ошибка
+static void handle_threads(CommandLineOptions* opts, const char* arg) {
+    if (arg) {
+        char* end = NULL;
+        errno = 0;
+        long threads = strtol(arg, &end, 10);
+        if (end == arg || *end != '\0' || errno == ERANGE || threads < 1 || threads > MAX_THREADS) {
+            fprintf(stderr, "Error: Invalid number of threads %s (expected an integer from 1 to %d)\n",
+                    arg, MAX_THREADS);
+            exit(EXIT_FAILURE);
+        }
+        opts->threads = (int)threads;
+    }
+}
+
+static void handle_batch(CommandLineOptions* opts, const char* arg) {
+    opts->batch = true;
+    if (arg && opts->batch_path == NULL) {
+        size_t len = strlen(arg);
+        opts->batch_path = (char*)malloc(len + 1);
+        if (opts->batch_path) {
+            memcpy(opts->batch_path, arg, len);
+            opts->batch_path[len] = '\0';
+        }
+    }
+}
+
+static void handle_serve(CommandLineOptions* opts, const char* arg) {
+    opts->serve = true;
+    if (arg && opts->serve_path == NULL) {
+        size_t len = strlen(arg);
+        opts->serve_path = (char*)malloc(len + 1);
+        if (opts->serve_path) {
+            memcpy(opts->serve_path, arg, len);
+            opts->serve_path[len] = '\0';
+        }
+    }
+}
+
+static void handle_cache(CommandLineOptions* opts, const char* arg) {
+    if (arg && opts->cache_path == NULL) {
+        size_t len = strlen(arg);
+        opts->cache_path = (char*)malloc(len + 1);
+        if (opts->cache_path) {
+            memcpy(opts->cache_path, arg, len);
+            opts->cache_path[len] = '\0';
+        }
+    }
+}
+
+static void handle_progressive(CommandLineOptions* opts, const char* arg) {
+    (void)arg;
+    opts->progressive = true;
+}
+
+static void handle_deadline(CommandLineOptions* opts, const char* arg) {
+    opts->progressive = true;
+    if (arg) {
+        opts->deadline_ms = atof(arg);
+        if (opts->deadline_ms < 0) opts->deadline_ms = 0;
+    }
+}
+
+static void handle_refine(CommandLineOptions* opts, const char* arg) {
+    opts->refine = true;
+    if (arg && opts->refine_params == NULL) {
+        size_t len = strlen(arg);
+        opts->refine_params = (char*)malloc(len + 1);
+        if (opts->refine_params) {
+            memcpy(opts->refine_params, arg, len);
+            opts->refine_params[len] = '\0';
+        }
+    }
+}
+
+static void handle_envelope(CommandLineOptions* opts, const char* arg) {
+    opts->envelope = true;
+    if (arg && opts->envelope_params == NULL) {
+        size_t len = strlen(arg);
+        opts->envelope_params = (char*)malloc(len + 1);
+        if (opts->envelope_params) {
+            memcpy(opts->envelope_params, arg, len);
+            opts->envelope_params[len] = '\0';
+        }
+    }
+}
+
+static void handle_method(CommandLineOptions* opts, const char* arg) {
+    if (arg && opts->method == NULL) {
+        size_t len = strlen(arg);
+        opts->method = (char*)malloc(len + 1);
+        if (opts->method) {
+            memcpy(opts->method, arg, len);
+            opts->method[len] = '\0';
+        }
+    }
+}
+
+// Число точек - целое больше нуля, иначе ошибка (а не молчаливая замена на 1)
+static void handle_samples(CommandLineOptions* opts, const char* arg) {
+    if (arg) {
+        char* end = NULL;
+        errno = 0;
+        long samples = strtol(arg, &end, 10);
+        if (end == arg || *end != '\0' || errno == ERANGE || samples < 1) {
+            fprintf(stderr, "Error: Invalid number of samples %s (expected a positive integer)\n", arg);
+            exit(EXIT_FAILURE);
+        }
+        opts->samples = samples;
+    }
+}
+
+static void handle_profile(CommandLineOptions* opts, const char* arg) {
+    (void)arg;
+    opts->profile = true;
+}
+
+static void handle_trace(CommandLineOptions* opts, const char* arg) {
+    if (arg && opts->trace_path == NULL) {
+        size_t len = strlen(arg);
+        opts->trace_path = (char*)malloc(len + 1);
+        if (opts->trace_path) {
+            memcpy(opts->trace_path, arg, len);
+            opts->trace_path[len] = '\0';
+        }
+    }
+}
+
+static void handle_root_method(CommandLineOptions* opts, const char* arg) {
+    if (arg && opts->root_method == NULL) {
+        size_t len = strlen(arg);
+        opts->root_method = (char*)malloc(len + 1);
+        if (opts->root_method) {
+            memcpy(opts->root_method, arg, len);
+            opts->root_method[len] = '\0';
+        }
+    }
+}
+
+static void handle_integrator(CommandLineOptions* opts, const char* arg) {
+    if (arg && opts->integrator == NULL) {
+        size_t len = strlen(arg);
+        opts->integrator = (char*)malloc(len + 1);
+        if (opts->integrator) {
+            memcpy(opts->integrator, arg, len);
+            opts->integrator[len] = '\0';
+        }
+    }
+}
+
+static void handle_compare(CommandLineOptions* opts, const char* arg) {
+    (void)arg;
+    opts->compare = true;
+}
+
+static void handle_spec(CommandLineOptions* opts, const char* arg) {
+    if (arg && opts->spec_path == NULL) {
+        size_t len = strlen(arg);
+        opts->spec_path = (char*)malloc(len + 1);
+        if (opts->spec_path) {
+            memcpy(opts->spec_path, arg, len);
+            opts->spec_path[len] = '\0';
+        }
+    }
+}
+
+static void handle_spec_cache(CommandLineOptions* opts, const char* arg) {
+    if (arg && opts->spec_cache_dir == NULL) {
+        size_t len = strlen(arg);
+        opts->spec_cache_dir = (char*)malloc(len + 1);
+        if (opts->spec_cache_dir) {
+            memcpy(opts->spec_cache_dir, arg, len);
+            opts->spec_cache_dir[len] = '\0';
+        }
+    }
+}
+
+// В отличие от остальных опций повторяется: каждый путь добавляется к списку
+static void handle_plugin(CommandLineOptions* opts, const char* arg) {
+    if (!arg) return;
+    if (opts->plugin_count == MAX_PLUGIN_PATHS) {
+        fprintf(stderr, "Warning: Too many plugins, %s ignored (max %d)\n", arg, MAX_PLUGIN_PATHS);
+        return;
+    }
+    size_t len = strlen(arg);
+    char* path = (char*)malloc(len + 1);
+    if (path) {
+        memcpy(path, arg, len);
+        path[len] = '\0';
+        opts->plugin_paths[opts->plugin_count++] = path;
+    }
+}
+
 static void handle_default(CommandLineOptions* opts, const char* arg) {
     (void)arg; // Не используем аргумент
     opts->help = true;
@@ -92,7 +305,7 @@ static void handle_default(CommandLineOptions* opts, const char* arg) {
 
 // Парсинг аргументов
 CommandLineOptions parse_args(int argc, char* argv[], Option* options, int count_of_options) {
-    CommandLineOptions opts = { false, false, false, false, false, NULL, NULL };
+    CommandLineOptions opts = { false, false, false, false, false, NULL, NULL, false, false, NULL, 0, false, NULL, false, NULL, NULL, false, 0.0, false, NULL, false, NULL, NULL, 0, false, NULL, NULL, NULL, false, NULL, NULL, { NULL }, 0 };
     
     // Создаем таблицу диспетчеризации обработчиков
     option_handler_t option_handlers[256] = {0}; // Инициализируем все нулями
@@ -101,6 +314,26 @@ CommandLineOptions parse_args(int argc, char* argv[], Option* options, int count
     option_handlers['i'] = handle_show_iterations;
     option_handlers['R'] = handle_test_root;
     option_handlers['I'] = handle_test_integral;
+    option_handlers['c'] = handle_chebyshev;
+    option_handlers['w'] = handle_warm_start;
+    option_handlers['t'] = handle_threads;
+    option_handlers['b'] = handle_batch;
+    option_handlers['s'] = handle_serve;
+    option_handlers['C'] = handle_cache;
+    option_handlers['p'] = handle_progressive;
+    option_handlers['d'] = handle_deadline;
+    option_handlers['e'] = handle_refine;
+    option_handlers['E'] = handle_envelope;
+    option_handlers['m'] = handle_method;
+    option_handlers['n'] = handle_samples;
+    option_handlers['P'] = handle_profile;
+    option_handlers['T'] = handle_trace;
+    option_handlers['M'] = handle_root_method;
+    option_handlers['g'] = handle_integrator;
+    option_handlers['x'] = handle_compare;
+    option_handlers['S'] = handle_spec;
+    option_handlers['D'] = handle_spec_cache;
+    option_handlers['L'] = handle_plugin;
     
     // Подготовка для getopt_long
     struct option* long_options = calloc(count_of_options + 1, sizeof(struct option));
@@ -228,13 +461,91 @@ bool parse_test_integral_params(const char* params, int* f, double* a, double* b
     return true;
 }
 
+// Список предыдущих корней через запятую: X1,X2,...
+// Пустые элементы и мусор после числа ("1x", "1,,2", "1,") - ошибка
+bool parse_double_list(const char* params, double* values, int max_values, int* count) {
+    if (!params || !values || !count) {
+        return false;
+    }
+    
+    *count = 0;
+    const char* p = params;
+    for (;;) {
+        if (*count >= max_values) return false;
+        
+        char* end = NULL;
+        values[*count] = strtod(p, &end);
+        if (end == p || (*end != ',' && *end != '\0') || !isfinite(values[*count])) return false;
+        (*count)++;
+        
+        if (*end == '\0') break;
+        p = end + 1;
+    }
+    
+    return true;
+}
+
+// Номера кривых через запятую
+bool parse_int_list(const char* params, int* values, int max_values, int* count) {
+    if (!params || !values || !count) {
+        return false;
+    }
+    
+    *count = 0;
+    const char* p = params;
+    while (*p) {
+        if (*count >= max_values) return false;
+        
+        char* end = NULL;
+        long value = strtol(p, &end, 10);
+        if (end == p || (*end != ',' && *end != '\0')) return false;
+        values[(*count)++] = (int)value;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    
+    return *count > 0;
+}
+
+bool parse_warm_start_params(const char* params, double* roots, int max_roots, int* count) {
+    return parse_double_list(params, roots, max_roots, count);
+}
+
 // Очистка ресурсов в CommandLineOptions
 void free_command_line_options(CommandLineOptions* opts) {
     if (opts) {
         free(opts->test_root_params);
         free(opts->test_integral_params);
+        free(opts->warm_start_params);
+        free(opts->batch_path);
+        free(opts->serve_path);
+        free(opts->cache_path);
+        free(opts->refine_params);
+        free(opts->envelope_params);
+        free(opts->method);
+        free(opts->trace_path);
+        free(opts->root_method);
+        free(opts->integrator);
+        free(opts->spec_path);
+        free(opts->spec_cache_dir);
+        for (int i = 0; i < opts->plugin_count; i++) {
+            free(opts->plugin_paths[i]);
+            opts->plugin_paths[i] = NULL;
+        }
+        opts->plugin_count = 0;
         opts->test_root_params = NULL;
         opts->test_integral_params = NULL;
+        opts->warm_start_params = NULL;
+        opts->batch_path = NULL;
+        opts->serve_path = NULL;
+        opts->cache_path = NULL;
+        opts->refine_params = NULL;
+        opts->envelope_params = NULL;
+        opts->method = NULL;
+        opts->trace_path = NULL;
+        opts->root_method = NULL;
+        opts->integrator = NULL;
+        opts->spec_path = NULL;
+        opts->spec_cache_dir = NULL;
     }
 }
 
@@ -3,6 +3,8 @@
 
 #include <stdbool.h>
 
+#define MAX_PLUGIN_PATHS 16
+
 typedef struct {
     char short_name;
     char* full_name;
@@ -18,14 +20,46 @@ typedef struct {
     bool test_integral;
     char* test_root_params;
     char* test_integral_params;
+    bool use_chebyshev;
+    bool warm_start;
+    char* warm_start_params;
+    int threads;            // 0 - последовательное вычисление
+    bool batch;
+    char* batch_path;
+    bool serve;
+    char* serve_path;
+    char* cache_path;       // NULL - без файла кэша
+    bool progressive;
+    double deadline_ms;     // 0 - без ограничения по времени
+    bool refine;
+    char* refine_params;    // Последовательность eps через запятую
+    bool envelope;
+    char* envelope_params;  // Номера кривых через запятую
+    char* method;           // Метод вычисления площади, NULL - по умолчанию
+    long samples;           // Число точек для --method qmc, 0 - по умолчанию
+    bool profile;           // Счетчики и время этапов (сборка с ENABLE_PROFILE)
+    char* trace_path;       // CSV трассы сходимости, NULL - без трассы
+    char* root_method;      // Ключ RootFinder в реестре, NULL - выбор при сборке
+    char* integrator;       // Ключ Integrator в реестре, NULL - выбор при сборке
+    bool compare;
+    char* spec_path;        // Спецификация кривых из кэша сборок, NULL - встроенные
+    char* spec_cache_dir;   // Каталог кэша --spec, NULL - свой каталог пользователя
+    char* plugin_paths[MAX_PLUGIN_PATHS];  // --plugin можно повторять
+    int plugin_count;
 } CommandLineOptions;
 
+#define MAX_WARM_START_ROOTS 16
+#define MAX_REFINE_STEPS 16
+
 Option create_option(char short_name, const char* full_name, const char* description, bool is_requires_arg);
 void free_option(Option* opt);
 void print_help(Option* options, int count_of_options);
 CommandLineOptions parse_args(int argc, char* argv[], Option* options, int count_of_options);
 bool parse_test_root_params(const char* params, int* f1, int* f2, double* a, double* b, double* eps, double* expected);
 bool parse_test_integral_params(const char* params, int* f, double* a, double* b, double* eps, double* expected);
+bool parse_int_list(const char* params, int* values, int max_values, int* count);
+bool parse_double_list(const char* params, double* values, int max_values, int* count);
+bool parse_warm_start_params(const char* params, double* roots, int max_roots, int* count);
 void free_command_line_options(CommandLineOptions* opts);
 void free_options(Option* options, int count);
 
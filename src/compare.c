@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "declarations.h"
+
+// Сравнение методов: каждая пара из реестра считает площадь на копии
+// фигуры, кривые которой обернуты счетчиком вызовов. Время - лучшее из
+// COMPARE_REPEATS прогонов, вызовы - за один прогон (значения и первые
+// производные; вторая производная Галлея вызывается напрямую и не считается)
+
+static double counted_function(void* ctx, double x) {
+    CallCounter* counter = (CallCounter*)ctx;
+    (*counter->calls)++;
+    return evaluate(counter->inner, x);
+}
+
+static double counted_derivative(void* ctx, double x) {
+    CallCounter* counter = (CallCounter*)ctx;
+    (*counter->calls)++;
+    return evaluate_derivative(counter->inner, x);
+}
+
+Function create_counted_function(CallCounter* counter, Function* inner, long* calls) {
+    counter->inner = inner;
+    counter->calls = calls;
+    Function f = create_context_function(counted_function, counted_derivative, counter, inner->name);
+    f.second_derivative = inner->second_derivative;
+    return f;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+double calculate_reference_area(Figure* fig) {
+    RootFinder rf = create_combined_method();
+    Integrator integ = create_adaptive_simpson_method();
+
+    double points[3];
+    int count = 0;
+    find_intersection_points(fig, REFERENCE_ROOT_EPS, &rf, points, &count);
+    if (count < 2) {
+        return -1.0;
+    }
+
+    double area = 0.0;
+    for (int i = 0; i < count - 1; i++) {
+        FunctionPair pair;
+        select_segment_bounds(fig, (points[i] + points[i + 1]) / 2, &pair);
+        Function diff = create_difference_function(&pair);
+        area += integ.integrate(&diff, points[i], points[i + 1], REFERENCE_INTEGRAL_EPS);
+    }
+    return area;
+}
+
+void compare_methods(Figure* fig, FILE* out) {
+    double reference = calculate_reference_area(fig);
+    fprintf(out, "Reference area: %.12f\n", reference);
+    fprintf(out, "%-24s %-18s %16s %10s %8s %10s\n", "root finder", "integrator", "area", "error", "evals",
+            "time ms");
+
+    long calls = 0;
+    CallCounter counters[3];
+    Figure counted = create_figure(create_counted_function(&counters[0], &fig->f1, &calls),
+                                   create_counted_function(&counters[1], &fig->f2, &calls),
+                                   create_counted_function(&counters[2], &fig->f3, &calls), fig->a, fig->b);
+
+    for (int r = 0; r < root_finder_registry_size; r++) {
+        for (int i = 0; i < integrator_registry_size; i++) {
+            RootFinder rf = root_finder_registry[r].create();
+            Integrator integ = integrator_registry[i].create();
+
+            double area = 0.0;
+            double best = HUGE_VAL;
+            for (int k = 0; k < COMPARE_REPEATS; k++) {
+                calls = 0;
+                double start = now_ms();
+                area = calculate_area(&counted, 0.001, &rf, &integ);
+                double elapsed = now_ms() - start;
+                if (elapsed < best) best = elapsed;
+            }
+
+            fprintf(out, "%-24s %-18s %16.10f %10.2e %8ld %10.3f\n", rf.name, integ.name, area,
+                    fabs(area - reference), calls, best);
+        }
+    }
+}
@@ -1,6 +1,11 @@
 #ifndef DECLARATIONS_H
 #define DECLARATIONS_H
 
+#include <stddef.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
 // Объявления функций из ассемблера
 extern double f1(double x);
 extern double f2(double x);
@@ -8,8 +13,13 @@ extern double f3(double x);
 extern double df1(double x);
 extern double df2(double x);
 extern double df3(double x);
+extern double ddf1(double x);
+extern double ddf2(double x);
+extern double ddf3(double x);
 
 typedef double (*afunc)(double);
+typedef void (*bfunc)(const double* x, double* y, size_t n);
+typedef double (*cfunc)(void* ctx, double x);
 
 double root(afunc f, afunc g, afunc df, afunc dg, double a, double b, double eps1);
 double integral(afunc f, double a, double b, double eps2);
@@ -18,47 +28,337 @@ double integral(afunc f, double a, double b, double eps2);
 typedef struct {
     afunc function;
     afunc derivative;
+    afunc second_derivative;   // NULL, если вторая производная неизвестна
+    bfunc batch;        // Пакетное вычисление значений, NULL - поэлементно через function
+    cfunc ctx_function;        // Если задана, используется вместо function (с контекстом ctx)
+    cfunc ctx_derivative;      // Если задана, используется вместо derivative
+    void* ctx;
     char* name;
+    // Счетчики есть в любой сборке, чтобы раскладка Function не зависела
+    // от флагов; растут только при ENABLE_PROFILE
+    unsigned long calls;            // Вызовы evaluate и точки evaluate_batch
+    unsigned long derivative_calls; // Вызовы evaluate_derivative
 } Function;
 
+// Пара кривых для составных функций (разность, модуль разности, max/min)
+typedef struct {
+    Function* upper;
+    Function* lower;
+} FunctionPair;
+
 // "main" abstract
 typedef struct {
     Function f1, f2, f3;
     double a, b;
 } Figure;
 
+// Итог решения уравнения f(x) = g(x)
+typedef enum {
+    SOLVE_CONVERGED,        // Достигнута заданная точность
+    SOLVE_EMPTY_INTERVAL,   // a = b, и a не является корнем
+    SOLVE_NO_SIGN_CHANGE,   // Не найден отрезок со сменой знака
+    SOLVE_MAX_ITERATIONS    // Исчерпан лимит итераций
+} SolveStatus;
+
+// События по ходу решения (не влияют на итог)
+#define SOLVE_FLAG_BRACKET_RESCANNED   1u  // На концах один знак, отрезок искался заново
+#define SOLVE_FLAG_DERIVATIVE_VANISHED 2u  // Производная обращалась в ноль, шаг заменялся
+
+typedef struct {
+    double root;
+    SolveStatus status;
+    unsigned flags;
+    int iterations;
+    double fa, fb;   // f - g на концах исходного отрезка
+    double lo, hi;   // Итоговый отрезок
+} SolveResult;
+
 typedef struct {
     const char* name;
     double (*solve)(Function* f, Function* g, double a, double b, double eps, int* iterations);
+    // n независимых отрезков [a[i], b[i]] для одной пары кривых
+    void (*solve_batch)(Function* f, Function* g, const double* a, const double* b, size_t n,
+                        double eps, double* roots, int* iters);
+    // Полный результат со статусом и диагностикой, без вывода
+    void (*solve_result)(Function* f, Function* g, double a, double b, double eps, SolveResult* result);
 } RootFinder;
 
+typedef struct Scheduler Scheduler;
+
 typedef struct {
     const char* name;
     double (*integrate)(Function* f, double a, double b, double eps);
+    // Разбиение на задачи планировщика, NULL - метод не умеет делиться
+    double (*integrate_parallel)(Function* f, double a, double b, double eps, Scheduler* sched);
 } Integrator;
 
 // Function wrapper
 Function create_function(afunc f, afunc df, const char* name);
+Function create_function_with_ddf(afunc f, afunc df, afunc ddf, const char* name);
+Function create_context_function(cfunc f, cfunc df, void* ctx, const char* name);
 double evaluate(Function* f, double x);
 double evaluate_derivative(Function* f, double x);
+double evaluate_second_derivative(Function* f, double x);
+void evaluate_batch(Function* f, const double* x, double* y, size_t n);
 
 // Figure wrapper
 Figure create_figure(Function f1, Function f2, Function f3, double a, double b);
+
+// Допуск площади eps делится между положением трех корней (AREA_ROOT_SHARE)
+// и квадратурой на двух сегментах (остальное); eps <= 0 - AREA_DEFAULT_EPS.
+// Если какая-то из трех точек пересечения не найдена, площадь равна -1
+#define AREA_DEFAULT_EPS 0.000001
+#define AREA_ROOT_SHARE 0.5
+#define AREA_MIN_SLOPE 1e-12
+
 double calculate_area(Figure* fig, double eps, RootFinder* rf, Integrator* integ);
+void split_area_tolerance(double eps, double* eps_root, double* eps2);
+double area_coarse_eps(double eps_root);
+void refine_area_root(Figure* fig, int pair, const double* points, double eps_root, RootFinder* rf,
+                      SolveResult* result);
+double area_root_error(Figure* fig, int pair, const double* points, const SolveResult* result);
+bool area_roots_converged(const SolveResult* roots);
 void find_intersection_points(Figure* fig, double eps1, RootFinder* rf, double* points, int* count);
 void find_intersection_points_with_iterations(Figure* fig, double eps1, RootFinder* rf, double* points, int* count, int* iterations);
+// Левая граница поиска корней: пары кривых могут пересекаться левее
+// отрезка фигуры, поиск идет на [min(INTERSECTION_SEARCH_LEFT, a), b]
+#define INTERSECTION_SEARCH_LEFT -4.0
+
+double solve_intersection(Figure* fig, int pair, double eps1, RootFinder* rf, int* iterations);
+void solve_intersection_result(Figure* fig, int pair, double eps1, RootFinder* rf, SolveResult* result);
+void get_pair_functions(Figure* fig, int pair, Function** f, Function** g);
+void sort_points(double* points, int count);
+void select_segment_bounds(Figure* fig, double x_mid, FunctionPair* pair);
+
+// Теплый старт: начальный радиус отрезка вокруг предыдущего корня,
+// множитель расширения и предельное число попыток. Отрезок не выходит
+// за область поиска, поэтому расширение заканчивается и раньше
+#define WARM_START_RADIUS 1e-3
+#define WARM_START_GROWTH 4.0
+#define WARM_START_MAX_STEPS 8
 
-// Для работы с разностью функций
-void set_difference_functions(Function* upper, Function* lower);
-double function_difference(double x);
+void find_intersection_points_warm(Figure* fig, double eps1, RootFinder* rf, const double* prior, int prior_count,
+                                   double* points, int* count, int* iterations);
+
+// Составные функции: pair должна жить, пока используется результат
+Function create_difference_function(FunctionPair* pair);
+Function create_abs_difference_function(FunctionPair* pair);
+Function create_max_function(FunctionPair* pair);
+Function create_min_function(FunctionPair* pair);
 
 // RootFinder и Integrator
 RootFinder create_combined_method(void);
 RootFinder create_bisection_method(void);
+RootFinder create_halley_method(void);
+RootFinder create_auto_method(void);
+void print_solve_status(FILE* out, const SolveResult* result);
 Integrator create_simpson_method(void);
+Integrator create_adaptive_simpson_method(void);
+Integrator create_auto_integrator(void);
+bool is_simpson_method(const Integrator* integ);
+
+// Специализированный Симпсон для разности двух встроенных кривых.
+// NULL - пары нет в таблице или метод не Симпсон, нужен обобщенный путь
+typedef double (*PairIntegral)(double a, double b, double eps);
+
+PairIntegral lookup_specialized_simpson(const Integrator* integ, const Function* upper, const Function* lower);
+
+// Реестр методов для выбора во время выполнения (--root-method, --integrator)
+typedef struct {
+    const char* key;                // Имя в командной строке
+    RootFinder (*create)(void);
+} RootFinderEntry;
+
+typedef struct {
+    const char* key;
+    Integrator (*create)(void);
+} IntegratorEntry;
+
+extern const RootFinderEntry root_finder_registry[];
+extern const int root_finder_registry_size;
+extern const IntegratorEntry integrator_registry[];
+extern const int integrator_registry_size;
+
+bool create_root_finder_by_name(const char* key, RootFinder* out);
+bool create_integrator_by_name(const char* key, Integrator* out);
+
+// Пошаговый составной метод Симпсона: каждое уточнение удваивает число
+// интервалов и переиспользует все ранее вычисленные узлы
+#define SIMPSON_START_INTERVALS 4
+#define SIMPSON_MAX_LEVEL 19
+
+typedef struct {
+    Function* f;
+    double a, b;
+    int n;              // Текущее число интервалов
+    int level;          // Число выполненных удвоений
+    double ends;        // f(a) + f(b)
+    double even;        // Сумма в четных внутренних узлах
+    double odd;         // Сумма в нечетных узлах
+    double result;
+    double previous;    // Оценка до последнего удвоения
+    int evaluations;
+    unsigned trace_run; // Номер в трассе сходимости (0 - трасса выключена)
+} SimpsonState;
+
+void simpson_start(SimpsonState* s, Function* f, double a, double b);
+double simpson_refine(SimpsonState* s);
+double simpson_error(const SimpsonState* s);
+
+// Постепенное вычисление площади: после каждого уточнения вызывается
+// callback с текущей оценкой; вернув false, он прекращает вычисление
+typedef struct {
+    double area;
+    double error;         // Оценка Ричардсона погрешности квадратуры плюс вклад корней
+    int step;
+    int evaluations;      // Вызовов кривых в квадратуре
+    double elapsed_ms;
+} AreaEstimate;
+
+typedef bool (*AreaCallback)(const AreaEstimate* estimate, void* ctx);
+
+// eps <= 0 - уточнять до deadline_ms, deadline_ms <= 0 - без ограничения времени.
+// Корни в этом случае уточняются до ошибки площади PROGRESSIVE_ROOT_EPS.
+// Если точки пересечения не найдены, area равна -1
+#define PROGRESSIVE_ROOT_EPS 1e-12
+AreaEstimate calculate_area_progressive(Figure* fig, double eps, double deadline_ms, RootFinder* rf,
+                                        AreaCallback callback, void* ctx);
+
+// Сеанс вычисления площади одной фигуры: хранит отрезки корней и
+// состояния метода Симпсона, поэтому запрос с меньшим eps только уточняет
+// корни на прежних отрезках и добавляет недостающие узлы. Сетка сегмента
+// строится заново, если корень ушел из него или сдвинулся дальше точности,
+// с которой сетка строилась; малые сдвиги досчитываются на краях.
+// fig и сам сеанс не должны перемещаться, пока сеанс используется
+typedef struct {
+    Figure* fig;
+    RootFinder* rf;
+    double root_eps;          // Для какой точности площади уточнены корни, 0 - корней еще нет
+    SolveResult roots[3];     // По парам кривых, как в solve_intersection
+    double points[3];         // Корни по возрастанию
+    int segments;
+    FunctionPair pairs[2];
+    Function diffs[2];
+    SimpsonState states[2];   // На отрезках между корнями, по которым строились
+    double grid_eps[2];       // Допустимый сдвиг края без перестройки сетки
+    double edges[2];          // Поправки на сдвиг корней относительно сеток
+    int root_generation;      // Число уточнений корней
+    int edges_generation;     // Для какого уточнения посчитаны edges
+    double edges_eps;         // И с какой точностью
+    int root_iterations;
+    int evaluations;          // Вызовов кривых в квадратуре, включая поправки
+} AreaSession;
+
+void area_session_init(AreaSession* s, Figure* fig, RootFinder* rf);
+double area_session_area(AreaSession* s, double eps);
+
+// Многопоточное вычисление площади
+#define MAX_THREADS 64
+#define MAX_AREA_CHUNKS 64
+#define AREA_CHUNK_WIDTH 0.25
+
+void run_parallel(int count, int threads, void (*run)(void* ctx, int index), void* ctx);
+double calculate_area_parallel(Figure* fig, double eps, RootFinder* rf, Integrator* integ, int threads);
+
+// Площадь между верхней и нижней огибающими n кривых на отрезке
+// между крайними точками их попарных пересечений внутри [a, b].
+// -1 - ошибка (уже напечатана): меньше двух пересечений или у пары их
+// больше ENVELOPE_PAIR_ROOTS
+#define ENVELOPE_MAX_CURVES 64
+#define ENVELOPE_GRID 512          // Ячеек сетки для отделения корней
+#define ENVELOPE_PAIR_ROOTS 32     // Предел пересечений одной пары кривых
+
+double calculate_envelope_area(Function* curves, int n, double a, double b, double eps,
+                               RootFinder* rf, Integrator* integ, int threads);
+
+// Оценка площади квази-Монте-Карло с доверительным интервалом 95%
+#define QMC_REPLICAS 16
+#define QMC_BLOCK 64               // Точек на один пакетный вызов кривых
+#define QMC_DEFAULT_SAMPLES (1L << 20)
+
+typedef struct {
+    double area;
+    double half_width;             // Полуширина доверительного интервала
+    long samples;
+    double seconds;
+} QmcEstimate;
+
+QmcEstimate calculate_area_qmc(Figure* fig, RootFinder* rf, long samples, int threads, uint64_t seed);
+
+// Эталонная площадь: корни и квадратура с запасом точности на порядки
+// больше, чем в calculate_area
+#define REFERENCE_ROOT_EPS 1e-13
+#define REFERENCE_INTEGRAL_EPS 1e-12
+
+double calculate_reference_area(Figure* fig);
+
+// Счетчик вызовов кривой (для --compare и bench): обертка с контекстом
+// вокруг исходной Function. Несколько оберток могут вести один общий
+// счетчик calls. Вторая производная (для Галлея) передается как есть
+// и не считается. counter должен жить, пока используется обертка
+typedef struct {
+    Function* inner;
+    long* calls;
+} CallCounter;
+
+Function create_counted_function(CallCounter* counter, Function* inner, long* calls);
+
+// Таблица всех пар RootFinder x Integrator из реестра на фигуре fig:
+// площадь, ошибка относительно эталона, вызовы кривых и время
+#define COMPARE_REPEATS 5
+
+void compare_methods(Figure* fig, FILE* out);
+
+// Чебышевские интерполянты кривых (строятся один раз, далее запросы почти бесплатны)
+#define CHEB_MAX_DEGREE 128
+#define CHEB_MAX_ROOTS 16
+
+typedef struct {
+    double a, b;
+    int degree;
+    double coeffs[CHEB_MAX_DEGREE + 1];
+} ChebyshevProxy;
+
+// Кэш интерполянтов по имени кривой и отрезку: повторные запросы площади
+// (--refine, --batch) на тех же кривых не вызывают кривые. Нулевая
+// структура - пустой кэш
+#define CHEB_CACHE_SIZE 16
+#define CHEB_NAME_LEN 96
+
+typedef struct {
+    char name[CHEB_NAME_LEN];
+    unsigned long stamp;        // Время последнего обращения, 0 - пустая запись
+    ChebyshevProxy proxy;
+} ChebyshevCacheEntry;
+
+typedef struct {
+    ChebyshevCacheEntry entries[CHEB_CACHE_SIZE];
+    unsigned long clock;
+    unsigned long hits, misses;
+    unsigned long evaluations;  // Вызовов кривых при построении интерполянтов
+} ChebyshevCache;
+
+// Возвращает число вызовов кривой
+int init_chebyshev_proxy(ChebyshevProxy* p, Function* f, double a, double b);
+double chebyshev_evaluate(const ChebyshevProxy* p, double x);
+double chebyshev_integrate(const ChebyshevProxy* p, double lo, double hi);
+int chebyshev_difference_roots(const ChebyshevProxy* p, const ChebyshevProxy* q, double* roots, int max_roots);
+const ChebyshevProxy* chebyshev_cache_proxy(ChebyshevCache* cache, Function* f, double a, double b);
+// Площадь фигуры по интерполянтам кривых на [a, b] (все пересечения на
+// отрезке), -1 - меньше двух точек пересечения
+double chebyshev_calculate_area(ChebyshevCache* cache, Figure* fig, double a, double b);
+
+// Кривые по номеру: 1..3 - встроенные, дальше - из плагинов (plugin/plugin.h)
+bool lookup_curve(int id, Function* out);
+// Кривые 1..3 для lookup_curve вместо встроенных (--spec), NULL - снова встроенные.
+// Массив должен жить, пока используется lookup_curve
+void set_lookup_curves(const Function* curves);
 
-// Testing
-void test_root(RootFinder* rf, int f1_idx, int f2_idx, double a, double b, double eps, double expected);
-void test_integral(Integrator* integ, int f_idx, double a, double b, double eps, double expected);
+// Testing: cache - кэш результатов (cache/cache.h, --cache) или NULL
+struct ResultCache;
+void test_root(struct ResultCache* cache, RootFinder* rf, int f1_idx, int f2_idx, double a, double b, double eps,
+               double expected);
+void test_integral(struct ResultCache* cache, Integrator* integ, int f_idx, double a, double b, double eps,
+                   double expected);
 
 #endif
\ No newline at end of file
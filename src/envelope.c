@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "declarations.h"
+
+// Площадь между верхней и нижней огибающими набора кривых.
+// 1. Кривые вычисляются на общей сетке (по кривой на задачу).
+// 2. Для каждой пары кривых смена знака разности на ячейке сетки дает
+//    отрезок, корни на всех отрезках пары уточняются одним solve_batch.
+// 3. Между соседними точками пересечения порядок кривых не меняется,
+//    поэтому верхняя и нижняя кривые куска берутся в его середине;
+//    соседние куски с той же парой кривых сливаются.
+// 4. Куски интегрируются параллельно, сумма - в порядке кусков.
+// Касания без смены знака и пары корней внутри одной ячейки не видны
+
+typedef struct {
+    Function* curves;
+    int n;
+    const double* grid;
+    double* samples;          // n * (ENVELOPE_GRID + 1)
+} SampleJob;
+
+typedef struct {
+    Function* curves;
+    const double* samples;
+    const double* grid;
+    RootFinder* rf;
+    double eps;
+    int* first;               // Пары (first[k], second[k])
+    int* second;
+    double* roots;            // ENVELOPE_PAIR_ROOTS на пару
+    int* counts;              // -1: пересечений больше ENVELOPE_PAIR_ROOTS
+} CrossingJob;
+
+typedef struct {
+    double a, b, eps;
+    FunctionPair pair;
+} EnvelopePiece;
+
+typedef struct {
+    Integrator* integ;
+    EnvelopePiece* pieces;
+    double* results;
+} PieceJob;
+
+static void run_sample(void* ctx, int index) {
+    SampleJob* job = (SampleJob*)ctx;
+    evaluate_batch(&job->curves[index], job->grid, job->samples + (size_t)index * (ENVELOPE_GRID + 1),
+                   ENVELOPE_GRID + 1);
+}
+
+static void run_crossings(void* ctx, int index) {
+    CrossingJob* job = (CrossingJob*)ctx;
+    const double* si = job->samples + (size_t)job->first[index] * (ENVELOPE_GRID + 1);
+    const double* sj = job->samples + (size_t)job->second[index] * (ENVELOPE_GRID + 1);
+
+    double lo[ENVELOPE_PAIR_ROOTS];
+    double hi[ENVELOPE_PAIR_ROOTS];
+    int iters[ENVELOPE_PAIR_ROOTS];
+    int count = 0;
+
+    for (int k = 1; k <= ENVELOPE_GRID; k++) {
+        if ((si[k - 1] - sj[k - 1] < 0.0) != (si[k] - sj[k] < 0.0)) {
+            // Лишние пересечения не отбрасываются молча: площадь была бы неверной
+            if (count == ENVELOPE_PAIR_ROOTS) {
+                job->counts[index] = -1;
+                return;
+            }
+            lo[count] = job->grid[k - 1];
+            hi[count] = job->grid[k];
+            count++;
+        }
+    }
+
+    job->counts[index] = count;
+    if (count > 0) {
+        job->rf->solve_batch(&job->curves[job->first[index]], &job->curves[job->second[index]],
+                             lo, hi, (size_t)count, job->eps, job->roots + (size_t)index * ENVELOPE_PAIR_ROOTS,
+                             iters);
+    }
+}
+
+static void run_piece(void* ctx, int index) {
+    PieceJob* job = (PieceJob*)ctx;
+    EnvelopePiece* piece = &job->pieces[index];
+
+    Function diff = create_difference_function(&piece->pair);
+    job->results[index] = job->integ->integrate(&diff, piece->a, piece->b, piece->eps);
+}
+
+static int compare_doubles(const void* x, const void* y) {
+    double a = *(const double*)x;
+    double b = *(const double*)y;
+    return (a > b) - (a < b);
+}
+
+static void* allocate(size_t count, size_t size) {
+    void* p = calloc(count, size);
+    if (!p) {
+        fprintf(stderr, "Memory allocation failed for envelope area\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Куски огибающих между соседними точками пересечения и их интегрирование
+static double integrate_envelopes(Function* curves, int n, const double* roots, int total, double eps,
+                                  Integrator* integ, int threads) {
+    // Верхняя и нижняя кривые куска - в его середине
+    EnvelopePiece* pieces = (EnvelopePiece*)allocate((size_t)total, sizeof(EnvelopePiece));
+    int piece_count = 0;
+
+    for (int k = 0; k + 1 < total; k++) {
+        double x0 = roots[k];
+        double x1 = roots[k + 1];
+        if (!(x1 > x0)) continue;  // Совпавшие пересечения
+
+        double mid = (x0 + x1) / 2;
+        int upper = 0;
+        int lower = 0;
+        double upper_value = evaluate(&curves[0], mid);
+        double lower_value = upper_value;
+        for (int i = 1; i < n; i++) {
+            double value = evaluate(&curves[i], mid);
+            if (value > upper_value) {
+                upper = i;
+                upper_value = value;
+            }
+            if (value < lower_value) {
+                lower = i;
+                lower_value = value;
+            }
+        }
+
+        if (piece_count > 0 && pieces[piece_count - 1].pair.upper == &curves[upper] &&
+            pieces[piece_count - 1].pair.lower == &curves[lower]) {
+            pieces[piece_count - 1].b = x1;  // Излом огибающих здесь не проходит
+            continue;
+        }
+
+        pieces[piece_count].a = x0;
+        pieces[piece_count].b = x1;
+        pieces[piece_count].pair.upper = &curves[upper];
+        pieces[piece_count].pair.lower = &curves[lower];
+        piece_count++;
+    }
+
+    for (int k = 0; k < piece_count; k++) {
+        pieces[k].eps = eps / piece_count;
+    }
+
+    double* results = (double*)allocate((size_t)piece_count, sizeof(double));
+    PieceJob piece_job = { integ, pieces, results };
+    run_parallel(piece_count, threads, run_piece, &piece_job);
+
+    double area = 0.0;
+    for (int k = 0; k < piece_count; k++) {
+        area += results[k];
+    }
+
+    free(results);
+    free(pieces);
+    return area;
+}
+
+double calculate_envelope_area(Function* curves, int n, double a, double b, double eps,
+                               RootFinder* rf, Integrator* integ, int threads) {
+    if (n < 2 || n > ENVELOPE_MAX_CURVES || !(b > a)) {
+        fprintf(stderr, "Error: Envelope area needs 2..%d curves and a < b\n", ENVELOPE_MAX_CURVES);
+        return -1.0;
+    }
+    if (threads < 1) threads = 1;
+
+    int pairs = n * (n - 1) / 2;
+    double* grid = (double*)allocate(ENVELOPE_GRID + 1, sizeof(double));
+    double* samples = (double*)allocate((size_t)n * (ENVELOPE_GRID + 1), sizeof(double));
+    int* first = (int*)allocate((size_t)pairs, sizeof(int));
+    int* second = (int*)allocate((size_t)pairs, sizeof(int));
+    double* roots = (double*)allocate((size_t)pairs * ENVELOPE_PAIR_ROOTS, sizeof(double));
+    int* counts = (int*)allocate((size_t)pairs, sizeof(int));
+
+    double h = (b - a) / ENVELOPE_GRID;
+    for (int k = 0; k <= ENVELOPE_GRID; k++) {
+        grid[k] = (k == ENVELOPE_GRID) ? b : a + k * h;
+    }
+
+    SampleJob sample_job = { curves, n, grid, samples };
+    run_parallel(n, threads, run_sample, &sample_job);
+
+    int p = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            first[p] = i;
+            second[p] = j;
+            p++;
+        }
+    }
+
+    // Точность корней с запасом: ошибка в корне дает ошибку площади порядка |Δf'| * δ²
+    CrossingJob crossing_job = { curves, samples, grid, rf, eps * 1e-3, first, second, roots, counts };
+    run_parallel(pairs, threads, run_crossings, &crossing_job);
+
+    // Все точки пересечения по возрастанию
+    int total = 0;
+    bool overflow = false;
+    for (int k = 0; k < pairs; k++) {
+        if (counts[k] < 0) {
+            fprintf(stderr, "Error: Curves %d and %d cross more than %d times\n", first[k] + 1, second[k] + 1,
+                    ENVELOPE_PAIR_ROOTS);
+            overflow = true;
+            continue;
+        }
+        for (int r = 0; r < counts[k]; r++) {
+            roots[total++] = roots[(size_t)k * ENVELOPE_PAIR_ROOTS + r];
+        }
+    }
+    qsort(roots, (size_t)total, sizeof(double), compare_doubles);
+
+    double area = -1.0;
+    if (!overflow && total < 2) {
+        fprintf(stderr, "Error: Failed to find enough intersection points\n");
+    } else if (!overflow) {
+        area = integrate_envelopes(curves, n, roots, total, eps, integ, threads);
+    }
+
+    free(grid);
+    free(samples);
+    free(first);
+    free(second);
+    free(roots);
+    free(counts);
+    return area;
+}
@@ -1,41 +1,293 @@
+#include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
 
 #include "declarations.h"
+#include "scheduler.h"
+#include "trace/trace.h"
 
-static double simpson_integrate(Function* f, double a, double b, double eps) {
-    int n = 4;  // Начальное число интервалов (должно быть четным)
-    int max_iterations = 20;  
-    double result_prev = 0.0;
-    double result = 0.0;
-    
-    for (int iterations = 0; iterations < max_iterations; iterations++) {
-        double h = (b - a) / n;
-        double sum = evaluate(f, a) + evaluate(f, b);  // Краевые точки
-        
-        for (int i = 1; i < n; i++) {
-            double x = a + i * h;
-            if (i % 2 == 0) {
-                sum += 2 * evaluate(f, x);  // Четные узлы
-            } else {
-                sum += 4 * evaluate(f, x);  // Нечетные узлы
-            }
+// Адаптивный Симпсон: предельная глубина деления и глубина,
+// до которой подотрезки раздаются планировщику как отдельные задачи
+#define ADAPTIVE_MAX_DEPTH 50
+#define ADAPTIVE_TASK_DEPTH 12
+#define ADAPTIVE_MAX_NODES (1 << (ADAPTIVE_TASK_DEPTH + 2))
+
+// Составной Симпсон: S = h/3 * (f(a) + f(b) + 4 * odd + 2 * even).
+// При удвоении n прежние узлы становятся четными, и вычислять
+// приходится только n новых нечетных узлов
+void simpson_start(SimpsonState* s, Function* f, double a, double b) {
+    s->f = f;
+    s->a = a;
+    s->b = b;
+    s->n = SIMPSON_START_INTERVALS;
+    s->level = 0;
+    s->trace_run = TRACE_BEGIN();
+    s->ends = evaluate(f, a) + evaluate(f, b);
+    s->even = 0.0;
+    s->odd = 0.0;
+    s->evaluations = 2;
+
+    double h = (b - a) / s->n;
+    for (int i = 1; i < s->n; i++) {
+        double value = evaluate(f, a + i * h);
+        if (i % 2 == 0) {
+            s->even += value;  // Четные узлы
+        } else {
+            s->odd += value;   // Нечетные узлы
         }
-        
-        result = sum * h / 3.0;
+    }
+    s->evaluations += s->n - 1;
+
+    s->result = (s->ends + 4 * s->odd + 2 * s->even) * h / 3.0;
+    s->previous = s->result;
+}
+
+double simpson_refine(SimpsonState* s) {
+    s->even += s->odd;
+    s->n *= 2;
+    s->level++;
+
+    double h = (s->b - s->a) / s->n;
+    double odd = 0.0;
+    for (int i = 1; i < s->n; i += 2) {
+        odd += evaluate(s->f, s->a + i * h);
+    }
+    s->odd = odd;
+    s->evaluations += s->n / 2;
+
+    s->previous = s->result;
+    s->result = (s->ends + 4 * s->odd + 2 * s->even) * h / 3.0;
+    TRACE_RECORD(TRACE_SIMPSON, s->trace_run, s->n, s->result, s->result - s->previous, h);
+    return s->result;
+}
+
+// Оценка Ричардсона для метода четвертого порядка: |S_n - S_{n/2}| / 15.
+// До первого удвоения оценки нет
+double simpson_error(const SimpsonState* s) {
+    return (s->level > 0) ? fabs(s->result - s->previous) / 15.0 : HUGE_VAL;
+}
+
+static double simpson_integrate(Function* f, double a, double b, double eps) {
+    SimpsonState state;
+    simpson_start(&state, f, a, b);
+    
+    while (state.level < SIMPSON_MAX_LEVEL) {
+        simpson_refine(&state);
         
         // Проверяем сходимость
-        if (iterations > 0 && fabs(result - result_prev) < eps) {
+        if (fabs(state.result - state.previous) < eps) {
             break;
         }
-        
-        result_prev = result;
-        n *= 2;  // Удваиваем число интервалов
     }
     
+    return state.result;
+}
+
+// Рекурсивный адаптивный метод Симпсона: отрезок делится пополам,
+// пока поправка Ричардсона больше допустимой
+static double adaptive_step(Function* f, double a, double b, double fa, double fm, double fb,
+                            double whole, double eps, int depth) {
+    double m = (a + b) / 2.0;
+    double lm = (a + m) / 2.0;
+    double rm = (m + b) / 2.0;
+    double flm = evaluate(f, lm);
+    double frm = evaluate(f, rm);
+    
+    double left = (m - a) / 6.0 * (fa + 4.0 * flm + fm);
+    double right = (b - m) / 6.0 * (fm + 4.0 * frm + fb);
+    double delta = left + right - whole;
+    
+    if (depth >= ADAPTIVE_MAX_DEPTH || fabs(delta) <= 15.0 * eps) {
+        return left + right + delta / 15.0;
+    }
+    
+    return adaptive_step(f, a, m, fa, flm, fm, left, eps / 2.0, depth + 1)
+         + adaptive_step(f, m, b, fm, frm, fb, right, eps / 2.0, depth + 1);
+}
+
+static double adaptive_simpson_integrate(Function* f, double a, double b, double eps) {
+    double fa = evaluate(f, a);
+    double fb = evaluate(f, b);
+    double fm = evaluate(f, (a + b) / 2.0);
+    double whole = (b - a) / 6.0 * (fa + 4.0 * fm + fb);
+    
+    return adaptive_step(f, a, b, fa, fm, fb, whole, eps, 0);
+}
+
+// Параллельный вариант: каждый подотрезок до глубины ADAPTIVE_TASK_DEPTH -
+// задача планировщика. Узлы дерева берутся из общего пула, а итог
+// собирается обходом дерева в том же порядке, что и в рекурсивной версии,
+// поэтому результат побитово совпадает с adaptive_simpson_integrate
+typedef struct AdaptiveJob AdaptiveJob;
+
+typedef struct {
+    Task task;                    // Должна быть первым полем
+    AdaptiveJob* job;
+    double a, b, fa, fm, fb, whole, eps;
+    int depth;
+    int left, right;              // Индексы детей в пуле, -1 для листа
+    double value;                 // Значение листа
+} AdaptiveNode;
+
+struct AdaptiveJob {
+    Function* f;
+    AdaptiveNode* nodes;
+    int used;
+};
+
+static void adaptive_task(Task* task, Scheduler* sched);
+
+static int adaptive_node(AdaptiveJob* job, double a, double b, double fa, double fm, double fb,
+                         double whole, double eps, int depth) {
+    int index = __atomic_fetch_add(&job->used, 1, __ATOMIC_RELAXED);
+    if (index >= ADAPTIVE_MAX_NODES) {
+        return -1;
+    }
+    
+    AdaptiveNode* node = &job->nodes[index];
+    node->task.run = adaptive_task;
+    node->job = job;
+    node->a = a;
+    node->b = b;
+    node->fa = fa;
+    node->fm = fm;
+    node->fb = fb;
+    node->whole = whole;
+    node->eps = eps;
+    node->depth = depth;
+    node->left = -1;
+    node->right = -1;
+    return index;
+}
+
+static void adaptive_task(Task* task, Scheduler* sched) {
+    AdaptiveNode* node = (AdaptiveNode*)task;
+    AdaptiveJob* job = node->job;
+    Function* f = job->f;
+    
+    // Ниже порога задачи слишком мелкие - досчитываем рекурсивно
+    if (node->depth >= ADAPTIVE_TASK_DEPTH) {
+        node->value = adaptive_step(f, node->a, node->b, node->fa, node->fm, node->fb,
+                                    node->whole, node->eps, node->depth);
+        return;
+    }
+    
+    double a = node->a, b = node->b;
+    double m = (a + b) / 2.0;
+    double flm = evaluate(f, (a + m) / 2.0);
+    double frm = evaluate(f, (m + b) / 2.0);
+    
+    double left = (m - a) / 6.0 * (node->fa + 4.0 * flm + node->fm);
+    double right = (b - m) / 6.0 * (node->fm + 4.0 * frm + node->fb);
+    double delta = left + right - node->whole;
+    
+    if (fabs(delta) <= 15.0 * node->eps) {
+        node->value = left + right + delta / 15.0;
+        return;
+    }
+    
+    int li = adaptive_node(job, a, m, node->fa, flm, node->fm, left, node->eps / 2.0, node->depth + 1);
+    int ri = adaptive_node(job, m, b, node->fm, frm, node->fb, right, node->eps / 2.0, node->depth + 1);
+    
+    if (li < 0 || ri < 0) {
+        // Пул исчерпан - считаем поддерево в этом потоке
+        node->value = adaptive_step(f, a, b, node->fa, node->fm, node->fb,
+                                    node->whole, node->eps, node->depth);
+        return;
+    }
+    
+    node->left = li;
+    node->right = ri;
+    scheduler_spawn(sched, &job->nodes[ri].task);
+    scheduler_spawn(sched, &job->nodes[li].task);
+}
+
+static double adaptive_sum(AdaptiveJob* job, int index) {
+    AdaptiveNode* node = &job->nodes[index];
+    if (node->left < 0) {
+        return node->value;
+    }
+    return adaptive_sum(job, node->left) + adaptive_sum(job, node->right);
+}
+
+static double adaptive_simpson_integrate_parallel(Function* f, double a, double b, double eps, Scheduler* sched) {
+    AdaptiveJob job;
+    job.f = f;
+    job.used = 0;
+    job.nodes = (AdaptiveNode*)malloc(ADAPTIVE_MAX_NODES * sizeof(AdaptiveNode));
+    if (!job.nodes) {
+        fprintf(stderr, "Memory allocation failed for adaptive Simpson nodes\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    double fa = evaluate(f, a);
+    double fb = evaluate(f, b);
+    double fm = evaluate(f, (a + b) / 2.0);
+    double whole = (b - a) / 6.0 * (fa + 4.0 * fm + fb);
+    
+    int root = adaptive_node(&job, a, b, fa, fm, fb, whole, eps, 0);
+    scheduler_run(sched, &job.nodes[root].task);
+    
+    double result = adaptive_sum(&job, root);
+    free(job.nodes);
     return result;
 }
 
+// Автовыбор квадратуры. Три уровня составного Симпсона (17 узлов) служат
+// пробой: если разности соседних оценок убывают примерно в 16 раз, функция
+// в асимптотическом режиме, и составной метод дойдет до eps дешевле всего,
+// переиспользуя все узлы пробы. Иначе у функции есть локальные особенности,
+// и адаптивный метод тратит узлы только там, где они нужны
+#define AUTO_RATIO_MIN 8.0
+#define AUTO_RATIO_MAX 32.0
+
+static double auto_integrate(Function* f, double a, double b, double eps) {
+    SimpsonState state;
+    simpson_start(&state, f, a, b);
+    
+    // simpson_refine обновляет state.previous: сначала вызов, потом разность
+    double first_estimate = simpson_refine(&state);
+    double first = fabs(first_estimate - state.previous);
+    if (first < eps) {
+        return state.result;
+    }
+    
+    double second_estimate = simpson_refine(&state);
+    double second = fabs(second_estimate - state.previous);
+    if (second < eps) {
+        return state.result;
+    }
+    
+    double ratio = first / second;
+    if (ratio < AUTO_RATIO_MIN || ratio > AUTO_RATIO_MAX) {
+        return adaptive_simpson_integrate(f, a, b, eps);
+    }
+    
+    while (state.level < SIMPSON_MAX_LEVEL) {
+        simpson_refine(&state);
+        if (fabs(state.result - state.previous) < eps) {
+            break;
+        }
+    }
+    
+    return state.result;
+}
+
 Integrator create_simpson_method(void) {
-    Integrator integ = { "Simpson", simpson_integrate };
+    Integrator integ = { "Simpson", simpson_integrate, NULL };
+    return integ;
+}
+
+bool is_simpson_method(const Integrator* integ) {
+    return integ->integrate == simpson_integrate;
+}
+
+Integrator create_adaptive_simpson_method(void) {
+    Integrator integ = { "Adaptive Simpson", adaptive_simpson_integrate, adaptive_simpson_integrate_parallel };
     return integ;
-}
\ No newline at end of file
+}
+
+Integrator create_auto_integrator(void) {
+    Integrator integ = { "Auto", auto_integrate, NULL };
+    return integ;
+}
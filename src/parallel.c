@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <pthread.h>
+
+#include "declarations.h"
+#include "scheduler.h"
+#include "profile/profile.h"
+
+// Пул потоков на один вызов: задачи раздаются по атомарному счетчику,
+// результат каждой задачи пишется в свой слот, поэтому порядок
+// выполнения не влияет на итог
+typedef struct {
+    void (*run)(void* ctx, int index);
+    void* ctx;
+    int count;
+    int next;
+} TaskQueue;
+
+static void* worker(void* arg) {
+    TaskQueue* queue = (TaskQueue*)arg;
+
+    for (;;) {
+        int index = __sync_fetch_and_add(&queue->next, 1);
+        if (index >= queue->count) break;
+        queue->run(queue->ctx, index);
+    }
+
+    return NULL;
+}
+
+void run_parallel(int count, int threads, void (*run)(void* ctx, int index), void* ctx) {
+    TaskQueue queue = { run, ctx, count, 0 };
+    pthread_t workers[MAX_THREADS];
+    int started = 0;
+
+    if (threads > count) threads = count;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    // Вызывающий поток работает наравне с остальными
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&workers[started], NULL, worker, &queue) != 0) {
+            break;  // Оставшиеся задачи доделают уже запущенные потоки
+        }
+        started++;
+    }
+
+    worker(&queue);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+}
+
+// Фаза 1: точки пересечения трех пар кривых
+typedef struct {
+    Figure* fig;
+    RootFinder* rf;
+    double eps_root;
+    SolveResult roots[3];
+    double coarse[3];        // Грубые корни по возрастанию (для второго прохода)
+    double points[3];
+} IntersectionJob;
+
+static void run_intersection(void* ctx, int index) {
+    IntersectionJob* job = (IntersectionJob*)ctx;
+    solve_intersection_result(job->fig, index, area_coarse_eps(job->eps_root), job->rf, &job->roots[index]);
+}
+
+// Второй проход: уточнение каждого корня до его доли допуска
+static void run_root_refinement(void* ctx, int index) {
+    IntersectionJob* job = (IntersectionJob*)ctx;
+    refine_area_root(job->fig, index, job->coarse, job->eps_root, job->rf, &job->roots[index]);
+    job->points[index] = job->roots[index].root;
+}
+
+// Фаза 2: интегрирование кусков сегментов
+typedef struct {
+    double a, b, eps;
+    FunctionPair pair;
+    PairIntegral special;   // Экземпляр для встроенных кривых или NULL
+} AreaChunk;
+
+typedef struct {
+    Integrator* integ;
+    AreaChunk chunks[MAX_AREA_CHUNKS];
+    double results[MAX_AREA_CHUNKS];
+} AreaJob;
+
+static void run_area_chunk(void* ctx, int index) {
+    AreaJob* job = (AreaJob*)ctx;
+    AreaChunk* chunk = &job->chunks[index];
+
+    if (chunk->special) {
+        job->results[index] = chunk->special(chunk->a, chunk->b, chunk->eps);
+        return;
+    }
+
+    // Функция разности живет на стеке потока, пара - в задании
+    Function diff = create_difference_function(&chunk->pair);
+    job->results[index] = job->integ->integrate(&diff, chunk->a, chunk->b, chunk->eps);
+}
+
+// Интегратор сам делит сегменты на задачи планировщика с перехватом работы
+static double integrate_segments_scheduled(Figure* fig, const double* points, Integrator* integ,
+                                           double eps2, int threads) {
+    Scheduler* sched = scheduler_create(threads);
+    double area = 0.0;
+
+    for (int i = 0; i < 2; i++) {
+        FunctionPair pair;
+        select_segment_bounds(fig, (points[i] + points[i + 1]) / 2, &pair);
+
+        Function diff = create_difference_function(&pair);
+        area += integ->integrate_parallel(&diff, points[i], points[i + 1], eps2, sched);
+    }
+
+    scheduler_destroy(sched);
+    return area;
+}
+
+// Площадь фигуры на нескольких потоках. Разбиение на куски зависит только
+// от геометрии (длина сегмента / AREA_CHUNK_WIDTH), а суммирование идет
+// в фиксированном порядке, поэтому результат побитово совпадает при любом threads
+double calculate_area_parallel(Figure* fig, double eps, RootFinder* rf, Integrator* integ, int threads) {
+    // Допуск делится так же, как в calculate_area
+    double eps_root, eps2;
+    split_area_tolerance(eps, &eps_root, &eps2);
+
+    PROFILE_START(roots_start);
+    IntersectionJob roots;
+    roots.fig = fig;
+    roots.rf = rf;
+    roots.eps_root = eps_root;
+    run_parallel(3, threads, run_intersection, &roots);
+    for (int i = 0; i < 3; i++) {
+        roots.coarse[i] = roots.roots[i].root;
+    }
+    sort_points(roots.coarse, 3);
+    run_parallel(3, threads, run_root_refinement, &roots);
+    sort_points(roots.points, 3);
+    PROFILE_STOP(PROFILE_ROOTS, roots_start);
+
+    if (!area_roots_converged(roots.roots)) {
+        return -1.0;
+    }
+
+    if (integ->integrate_parallel) {
+        PROFILE_START(scheduled_start);
+        double area = integrate_segments_scheduled(fig, roots.points, integ, eps2, threads);
+        PROFILE_STOP(PROFILE_INTEGRATION, scheduled_start);
+        return area;
+    }
+
+    AreaJob job;
+    job.integ = integ;
+    int count = 0;
+
+    for (int i = 0; i < 2; i++) {
+        double a = roots.points[i];
+        double b = roots.points[i + 1];
+
+        FunctionPair pair;
+        PROFILE_START(bounds_start);
+        select_segment_bounds(fig, (a + b) / 2, &pair);
+        PROFILE_STOP(PROFILE_BOUNDS, bounds_start);
+        PairIntegral special = lookup_specialized_simpson(integ, pair.upper, pair.lower);
+
+        // Длинные сегменты режем на равные куски, точность делим между ними
+        int pieces = (int)((b - a) / AREA_CHUNK_WIDTH) + 1;
+        if (pieces > MAX_AREA_CHUNKS / 2) pieces = MAX_AREA_CHUNKS / 2;
+
+        double h = (b - a) / pieces;
+        for (int k = 0; k < pieces; k++) {
+            job.chunks[count].a = a + k * h;
+            job.chunks[count].b = (k == pieces - 1) ? b : a + (k + 1) * h;
+            job.chunks[count].eps = eps2 / pieces;
+            job.chunks[count].pair = pair;
+            job.chunks[count].special = special;
+            count++;
+        }
+    }
+
+    PROFILE_START(integration_start);
+    run_parallel(count, threads, run_area_chunk, &job);
+    PROFILE_STOP(PROFILE_INTEGRATION, integration_start);
+
+    // Детерминированная редукция: строго по порядку кусков
+    double area = 0.0;
+    for (int i = 0; i < count; i++) {
+        area += job.results[i];
+    }
+
+    return area;
+}
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "plugin.h"
+#include "../cache/cache.h"
+
+static void* libraries[PLUGIN_MAX_LIBRARIES];
+static int library_count = 0;
+
+static Function curves[PLUGIN_MAX_CURVES];
+static char names[PLUGIN_MAX_CURVES][PLUGIN_NAME_LEN];
+static int curve_count = 0;
+
+// Описатель проверяется целиком до регистрации: либо добавляются
+// все кривые библиотеки, либо ни одной
+static bool check_descriptor(const char* path, const IntegralPluginDescriptor* d) {
+    if (d->abi_version != INTEGRAL_PLUGIN_ABI_VERSION) {
+        fprintf(stderr, "Error: Plugin %s has ABI version %u, expected %d\n", path,
+                (unsigned)d->abi_version, INTEGRAL_PLUGIN_ABI_VERSION);
+        return false;
+    }
+    if (d->curve_count == 0 || !d->curves) {
+        fprintf(stderr, "Error: Plugin %s has no curves\n", path);
+        return false;
+    }
+    if (d->curve_count > (uint32_t)(PLUGIN_MAX_CURVES - curve_count)) {
+        fprintf(stderr, "Error: Plugin %s exceeds the limit of %d plugin curves\n", path, PLUGIN_MAX_CURVES);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < d->curve_count; i++) {
+        const IntegralPluginCurve* c = &d->curves[i];
+        if (!c->name || !c->value || !c->derivative) {
+            fprintf(stderr, "Error: Plugin %s curve %u needs a name, value and derivative\n", path, (unsigned)i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Хэш содержимого файла: пересобранный плагин или другой файл с тем же
+// именем получает другие имена кривых и не видит чужих записей кэша
+static bool hash_file(int fd, const char* path, uint64_t* hash) {
+    unsigned char chunk[1024];
+    ssize_t n;
+    *hash = CACHE_HASH_SEED;
+    while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+        *hash = cache_hash_bytes(*hash, chunk, (size_t)n);
+    }
+    if (n < 0) {
+        perror(path);
+        return false;
+    }
+    return true;
+}
+
+bool plugin_load(const char* path) {
+    if (library_count == PLUGIN_MAX_LIBRARIES) {
+        fprintf(stderr, "Error: Too many plugins (max %d)\n", PLUGIN_MAX_LIBRARIES);
+        return false;
+    }
+
+    // path - путь к файлу, а не имя для поиска по LD_LIBRARY_PATH. Файл
+    // открывается один раз, и dlopen получает тот же файл, что и хэш, через
+    // /proc/self/fd: подмена файла между хэшем и загрузкой не проходит
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+
+    uint64_t identity;
+    if (!hash_file(fd, path, &identity)) {
+        close(fd);
+        return false;
+    }
+
+    char fd_path[32];
+    snprintf(fd_path, sizeof(fd_path), "/proc/self/fd/%d", fd);
+    void* handle = dlopen(fd_path, RTLD_NOW | RTLD_LOCAL);
+    close(fd);
+    if (!handle) {
+        fprintf(stderr, "Error: Plugin %s: %s\n", path, dlerror());
+        return false;
+    }
+
+    const IntegralPluginDescriptor* d =
+        (const IntegralPluginDescriptor*)dlsym(handle, INTEGRAL_PLUGIN_SYMBOL);
+    if (!d) {
+        fprintf(stderr, "Error: Plugin %s does not export %s\n", path, INTEGRAL_PLUGIN_SYMBOL);
+        dlclose(handle);
+        return false;
+    }
+    if (!check_descriptor(path, d)) {
+        dlclose(handle);
+        return false;
+    }
+
+    // Имя в реестре - <файл>:<кривая>@<хэш содержимого>: ключи кэша
+    // результатов не путают одноименные кривые разных плагинов и сборок.
+    // Длинное имя укорачивается, хэш сохраняется всегда
+    const char* base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+
+    for (uint32_t i = 0; i < d->curve_count; i++) {
+        const IntegralPluginCurve* c = &d->curves[i];
+        char label[PLUGIN_NAME_LEN];
+        snprintf(label, sizeof(label), "%s:%s", base, c->name);
+        snprintf(names[curve_count], PLUGIN_NAME_LEN, "%.*s@%016llx", PLUGIN_NAME_LEN - 18, label,
+                 (unsigned long long)identity);
+
+        Function f = create_function_with_ddf(c->value, c->derivative, c->second_derivative, names[curve_count]);
+        f.batch = c->batch;
+        curves[curve_count++] = f;
+    }
+
+    libraries[library_count++] = handle;
+    return true;
+}
+
+void plugin_unload_all(void) {
+    for (int i = library_count - 1; i >= 0; i--) {
+        dlclose(libraries[i]);
+    }
+    library_count = 0;
+    curve_count = 0;
+}
+
+int plugin_curve_count(void) {
+    return curve_count;
+}
+
+bool plugin_lookup_curve(int index, Function* out) {
+    if (index < 0 || index >= curve_count) {
+        return false;
+    }
+    *out = curves[index];
+    return true;
+}
+
+void plugin_print_curves(FILE* out) {
+    for (int i = 0; i < curve_count; i++) {
+        fprintf(out, "Curve %d: %s\n", PLUGIN_FIRST_CURVE + i, curves[i].name);
+    }
+}
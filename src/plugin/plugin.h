@@ -0,0 +1,29 @@
+#ifndef PLUGIN_H
+#define PLUGIN_H
+
+#include <stdbool.h>
+
+#include "../declarations.h"
+#include "plugin_abi.h"
+
+// Реестр кривых из плагинов. Кривые получают номера lookup_curve после
+// встроенных (PLUGIN_FIRST_CURVE и дальше в порядке загрузки), поэтому
+// доступны в пакетном режиме, сервере, --envelope и --test-root.
+// Библиотеки остаются загруженными до plugin_unload_all, и один процесс
+// обслуживает задания любых загруженных семейств без пересборки.
+// Загрузка - до запуска потоков, дальше реестр только читается
+
+#define PLUGIN_FIRST_CURVE 4
+#define PLUGIN_MAX_LIBRARIES 16
+#define PLUGIN_MAX_CURVES 256
+#define PLUGIN_NAME_LEN 64
+
+// false - ошибка (уже напечатана), реестр не меняется
+bool plugin_load(const char* path);
+void plugin_unload_all(void);
+
+int plugin_curve_count(void);
+bool plugin_lookup_curve(int index, Function* out);
+void plugin_print_curves(FILE* out);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef PLUGIN_ABI_H
+#define PLUGIN_ABI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ABI подключаемых кривых (integral --plugin PATH).
+// Разделяемая библиотека экспортирует под именем INTEGRAL_PLUGIN_SYMBOL
+// описатель с таблицей кривых. Заголовок самодостаточен: плагину не нужны
+// остальные заголовки integral. Таблица и имена должны жить, пока
+// библиотека загружена (обычно это статические данные)
+
+#define INTEGRAL_PLUGIN_ABI_VERSION 1
+#define INTEGRAL_PLUGIN_SYMBOL "integral_plugin"
+
+typedef struct {
+    const char* name;
+    double (*value)(double x);
+    double (*derivative)(double x);
+    double (*second_derivative)(double x);                // NULL, если неизвестна
+    void (*batch)(const double* x, double* y, size_t n);  // NULL - поэлементно через value
+} IntegralPluginCurve;
+
+typedef struct {
+    uint32_t abi_version;        // INTEGRAL_PLUGIN_ABI_VERSION
+    uint32_t curve_count;
+    const IntegralPluginCurve* curves;
+} IntegralPluginDescriptor;
+
+#endif
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "profile.h"
+
+#ifdef ENABLE_PROFILE
+
+typedef struct {
+    double total_ns;
+    unsigned long calls;
+} PhaseTimer;
+
+static const char* phase_names[PROFILE_PHASES] = { "roots", "bounds", "integration" };
+
+// Этап заканчивается редко (несколько раз на площадь), блокировка дешевле,
+// чем атомарные операции над double на -m32
+static PhaseTimer phases[PROFILE_PHASES];
+static pthread_mutex_t phases_lock = PTHREAD_MUTEX_INITIALIZER;
+
+double profile_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void profile_add_phase(ProfilePhase phase, double ns) {
+    pthread_mutex_lock(&phases_lock);
+    phases[phase].total_ns += ns;
+    phases[phase].calls++;
+    pthread_mutex_unlock(&phases_lock);
+}
+
+bool profile_enabled(void) {
+    return true;
+}
+
+static void print_counters(FILE* out, const Function* f) {
+    fprintf(out, "  %-12s %10lu evaluations %10lu derivatives\n", f->name,
+            __atomic_load_n(&f->calls, __ATOMIC_RELAXED),
+            __atomic_load_n(&f->derivative_calls, __ATOMIC_RELAXED));
+}
+
+void profile_print(FILE* out, const Figure* fig) {
+    pthread_mutex_lock(&phases_lock);
+    double total = 0.0;
+    for (int i = 0; i < PROFILE_PHASES; i++) {
+        total += phases[i].total_ns;
+    }
+
+    fprintf(out, "Profile (calculate_area phases):\n");
+    for (int i = 0; i < PROFILE_PHASES; i++) {
+        fprintf(out, "  %-12s %10.3f ms %6.1f%% %8lu calls\n", phase_names[i], phases[i].total_ns / 1e6,
+                total > 0 ? 100.0 * phases[i].total_ns / total : 0.0, phases[i].calls);
+    }
+    pthread_mutex_unlock(&phases_lock);
+
+    fprintf(out, "Profile (curve calls):\n");
+    print_counters(out, &fig->f1);
+    print_counters(out, &fig->f2);
+    print_counters(out, &fig->f3);
+}
+
+#else
+
+bool profile_enabled(void) {
+    return false;
+}
+
+void profile_print(FILE* out, const Figure* fig) {
+    (void)fig;
+    fprintf(out, "Profiling is compiled out, rebuild with make profile\n");
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+
+#include "../declarations.h"
+
+// Профилирование конвейера площади: счетчики вызовов каждой Function
+// (через evaluate, evaluate_derivative и evaluate_batch) и время этапов
+// calculate_area по монотонным часам. Включается сборкой с
+// -DENABLE_PROFILE (make profile); без него макросы раскрываются в пустоту,
+// и поля счетчиков Function остаются нулевыми
+
+typedef enum {
+    PROFILE_ROOTS,          // Поиск точек пересечения
+    PROFILE_BOUNDS,         // Выбор верхней и нижней кривых сегментов
+    PROFILE_INTEGRATION,    // Интегрирование разностей по сегментам
+    PROFILE_PHASES
+} ProfilePhase;
+
+#ifdef ENABLE_PROFILE
+
+// Счетчики общие для потоков parallel/server, поэтому атомарные
+#define PROFILE_COUNT(counter, n) ((void)__atomic_add_fetch(&(counter), (n), __ATOMIC_RELAXED))
+#define PROFILE_START(start) double start = profile_now_ns()
+#define PROFILE_STOP(phase, start) profile_add_phase((phase), profile_now_ns() - (start))
+
+double profile_now_ns(void);
+void profile_add_phase(ProfilePhase phase, double ns);
+
+#else
+
+#define PROFILE_COUNT(counter, n) ((void)0)
+#define PROFILE_START(start) ((void)0)
+#define PROFILE_STOP(phase, start) ((void)0)
+
+#endif
+
+// false, если профилирование вырезано при сборке
+bool profile_enabled(void);
+
+// Время этапов и счетчики вызовов кривых фигуры; без ENABLE_PROFILE -
+// подсказка, как собрать программу с профилированием
+void profile_print(FILE* out, const Figure* fig);
+
+#endif
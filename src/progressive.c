@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "declarations.h"
+
+static double elapsed_ms(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Сумма по сегментам; погрешность - сумма оценок Ричардсона и вклада корней
+static void collect(const SimpsonState* states, int segments, double root_error, AreaEstimate* estimate) {
+    estimate->area = 0.0;
+    estimate->error = root_error;
+    estimate->evaluations = 0;
+
+    for (int i = 0; i < segments; i++) {
+        estimate->area += states[i].result;
+        estimate->error += simpson_error(&states[i]);
+        estimate->evaluations += states[i].evaluations;
+    }
+}
+
+// Та же схема, что и в calculate_area, но метод Симпсона ведется пошагово:
+// на каждом шаге удваивается сетка сегмента с наибольшей оценкой погрешности
+AreaEstimate calculate_area_progressive(Figure* fig, double eps, double deadline_ms, RootFinder* rf,
+                                        AreaCallback callback, void* ctx) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    AreaEstimate estimate = { -1.0, HUGE_VAL, 0, 0, 0.0 };
+
+    // Корни уточняются один раз, как в calculate_area: их доля допуска
+    // входит в итоговую погрешность и дальше не уменьшается. Без eps (до
+    // срока) корни уточняются до PROGRESSIVE_ROOT_EPS
+    double eps_root, eps2;
+    split_area_tolerance(eps > 0 ? eps : PROGRESSIVE_ROOT_EPS, &eps_root, &eps2);
+
+    SolveResult roots[3];
+    double coarse[3];
+    for (int pair = 0; pair < 3; pair++) {
+        solve_intersection_result(fig, pair, area_coarse_eps(eps_root), rf, &roots[pair]);
+        coarse[pair] = roots[pair].root;
+    }
+    sort_points(coarse, 3);
+
+    double points[3];
+    for (int pair = 0; pair < 3; pair++) {
+        refine_area_root(fig, pair, coarse, eps_root, rf, &roots[pair]);
+        points[pair] = roots[pair].root;
+    }
+    sort_points(points, 3);
+
+    if (!area_roots_converged(roots)) {
+        return estimate;
+    }
+
+    double root_error = 0.0;
+    for (int pair = 0; pair < 3; pair++) {
+        root_error += area_root_error(fig, pair, points, &roots[pair]);
+    }
+
+    // Пары и функции разности должны жить, пока живут состояния
+    int segments = 2;
+    FunctionPair pairs[2];
+    Function diffs[2];
+    SimpsonState states[2];
+
+    for (int i = 0; i < segments; i++) {
+        select_segment_bounds(fig, (points[i] + points[i + 1]) / 2, &pairs[i]);
+        diffs[i] = create_difference_function(&pairs[i]);
+        simpson_start(&states[i], &diffs[i], points[i], points[i + 1]);
+        simpson_refine(&states[i]);  // Без второго уровня нет оценки погрешности
+    }
+
+    for (;;) {
+        collect(states, segments, root_error, &estimate);
+        estimate.elapsed_ms = elapsed_ms(&start);
+
+        if (callback && !callback(&estimate, ctx)) break;
+        if (eps > 0 && estimate.error <= eps) break;
+        if (deadline_ms > 0 && estimate.elapsed_ms >= deadline_ms) break;
+
+        int worst = -1;
+        for (int i = 0; i < segments; i++) {
+            if (states[i].level < SIMPSON_MAX_LEVEL &&
+                (worst < 0 || simpson_error(&states[i]) > simpson_error(&states[worst]))) {
+                worst = i;
+            }
+        }
+        if (worst < 0) break;  // Все сегменты на предельной сетке
+
+        // Уточнение стоит states[worst].n новых узлов: не начинаем его,
+        // если по средней цене вызова оно не успеет до срока
+        double per_evaluation = estimate.elapsed_ms / estimate.evaluations;
+        if (deadline_ms > 0 && estimate.elapsed_ms + per_evaluation * states[worst].n > deadline_ms) break;
+
+        simpson_refine(&states[worst]);
+        estimate.step++;
+    }
+
+    return estimate;
+}
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "declarations.h"
+
+// Квази-Монте-Карло: точки Холтона (основания 2 и 3) в прямоугольнике,
+// охватывающем фигуру. Каждая реплика сдвигает всю последовательность
+// на свой случайный вектор по модулю 1 (сдвиг Кранли-Паттерсона), так что
+// реплики независимы и дают доверительный интервал. Сдвиг берется из
+// счетчика splitmix64(seed, номер реплики), поэтому результат не зависит
+// от числа потоков и порядка выполнения реплик
+
+#define QMC_BOX_SAMPLES 1024   // Узлов для оценки высоты прямоугольника
+#define QMC_BOX_MARGIN 0.05
+#define QMC_T_QUANTILE 2.131   // t(0.975) для QMC_REPLICAS - 1 = 15 степеней свободы
+
+typedef struct {
+    Figure* fig;
+    double x0, width;
+    double y0, height;
+    long per_replica;
+    uint64_t seed;
+    long inside[QMC_REPLICAS];
+} QmcJob;
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static double to_unit_interval(uint64_t x) {
+    return (x >> 11) * (1.0 / 9007199254740992.0);  // 53 бита в [0, 1)
+}
+
+// Обращение цифр индекса по основанию 2 - через перестановку битов
+static double radical_inverse_2(uint32_t i) {
+    i = (i << 16) | (i >> 16);
+    i = ((i & 0x00ff00ffu) << 8) | ((i & 0xff00ff00u) >> 8);
+    i = ((i & 0x0f0f0f0fu) << 4) | ((i & 0xf0f0f0f0u) >> 4);
+    i = ((i & 0x33333333u) << 2) | ((i & 0xccccccccu) >> 2);
+    i = ((i & 0x55555555u) << 1) | ((i & 0xaaaaaaaau) >> 1);
+    return i * (1.0 / 4294967296.0);
+}
+
+static double radical_inverse_3(uint32_t i) {
+    double result = 0.0;
+    double scale = 1.0 / 3.0;
+    while (i > 0) {
+        result += (i % 3) * scale;
+        i /= 3;
+        scale /= 3.0;
+    }
+    return result;
+}
+
+static double shifted(double u, double shift) {
+    u += shift;
+    return (u >= 1.0) ? u - 1.0 : u;
+}
+
+// Подсчет точек между нижней и верхней огибающими. Цикл без ветвлений:
+// компилятор векторизует его, если целевая архитектура дает SIMD
+// (в сборке -m32 вычисления идут на x87, и цикл остается скалярным)
+static long count_inside(const double* y, const double* v1, const double* v2, const double* v3, int n) {
+    long inside = 0;
+    for (int i = 0; i < n; i++) {
+        double hi = v1[i] > v2[i] ? v1[i] : v2[i];
+        double lo = v1[i] < v2[i] ? v1[i] : v2[i];
+        hi = hi > v3[i] ? hi : v3[i];
+        lo = lo < v3[i] ? lo : v3[i];
+        inside += (y[i] >= lo) & (y[i] <= hi);
+    }
+    return inside;
+}
+
+static void run_replica(void* ctx, int replica) {
+    QmcJob* job = (QmcJob*)ctx;
+    double shift_x = to_unit_interval(splitmix64(job->seed + 2 * (uint64_t)replica));
+    double shift_y = to_unit_interval(splitmix64(job->seed + 2 * (uint64_t)replica + 1));
+
+    double x[QMC_BLOCK], y[QMC_BLOCK];
+    double v1[QMC_BLOCK], v2[QMC_BLOCK], v3[QMC_BLOCK];
+    long inside = 0;
+
+    for (long start = 0; start < job->per_replica; start += QMC_BLOCK) {
+        int n = (job->per_replica - start < QMC_BLOCK) ? (int)(job->per_replica - start) : QMC_BLOCK;
+
+        for (int i = 0; i < n; i++) {
+            uint32_t index = (uint32_t)(start + i + 1);  // Нулевая точка Холтона вырождена
+            x[i] = job->x0 + job->width * shifted(radical_inverse_2(index), shift_x);
+            y[i] = job->y0 + job->height * shifted(radical_inverse_3(index), shift_y);
+        }
+
+        evaluate_batch(&job->fig->f1, x, v1, (size_t)n);
+        evaluate_batch(&job->fig->f2, x, v2, (size_t)n);
+        evaluate_batch(&job->fig->f3, x, v3, (size_t)n);
+        inside += count_inside(y, v1, v2, v3, n);
+    }
+
+    job->inside[replica] = inside;
+}
+
+// Прямоугольник по x - между крайними точками пересечения, по y - по
+// значениям кривых на сетке с запасом QMC_BOX_MARGIN от высоты
+static void bounding_box(Figure* fig, double x0, double x1, double* y0, double* y1) {
+    double lo = evaluate(&fig->f1, x0);
+    double hi = lo;
+
+    for (int k = 0; k <= QMC_BOX_SAMPLES; k++) {
+        double x = x0 + (x1 - x0) * k / QMC_BOX_SAMPLES;
+        double values[3] = { evaluate(&fig->f1, x), evaluate(&fig->f2, x), evaluate(&fig->f3, x) };
+        for (int i = 0; i < 3; i++) {
+            if (values[i] < lo) lo = values[i];
+            if (values[i] > hi) hi = values[i];
+        }
+    }
+
+    double margin = QMC_BOX_MARGIN * (hi - lo);
+    *y0 = lo - margin;
+    *y1 = hi + margin;
+}
+
+QmcEstimate calculate_area_qmc(Figure* fig, RootFinder* rf, long samples, int threads, uint64_t seed) {
+    QmcEstimate estimate = { -1.0, 0.0, 0, 0.0 };
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    double points[3];
+    int count = 0;
+    find_intersection_points(fig, 0.000001, rf, points, &count);
+
+    if (count < 2) {
+        fprintf(stderr, "Error: Failed to find enough intersection points\n");
+        return estimate;
+    }
+
+    QmcJob job;
+    job.fig = fig;
+    job.x0 = points[0];
+    job.width = points[count - 1] - points[0];
+    double y1;
+    bounding_box(fig, points[0], points[count - 1], &job.y0, &y1);
+    job.height = y1 - job.y0;
+    job.per_replica = (samples + QMC_REPLICAS - 1) / QMC_REPLICAS;
+    job.seed = seed;
+
+    run_parallel(QMC_REPLICAS, threads > 0 ? threads : 1, run_replica, &job);
+
+    // Среднее и стандартная ошибка по репликам
+    double box = job.width * job.height;
+    double mean = 0.0;
+    double values[QMC_REPLICAS];
+    for (int r = 0; r < QMC_REPLICAS; r++) {
+        values[r] = box * job.inside[r] / job.per_replica;
+        mean += values[r];
+    }
+    mean /= QMC_REPLICAS;
+
+    double variance = 0.0;
+    for (int r = 0; r < QMC_REPLICAS; r++) {
+        variance += (values[r] - mean) * (values[r] - mean);
+    }
+    variance /= QMC_REPLICAS - 1;
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    estimate.area = mean;
+    estimate.half_width = QMC_T_QUANTILE * sqrt(variance / QMC_REPLICAS);
+    estimate.samples = job.per_replica * QMC_REPLICAS;
+    estimate.seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    return estimate;
+}
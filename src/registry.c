@@ -0,0 +1,40 @@
+#include <string.h>
+
+#include "declarations.h"
+
+// Все методы, которые можно выбрать во время выполнения.
+// Первый элемент - метод по умолчанию без флагов USE_*
+const RootFinderEntry root_finder_registry[] = {
+    { "combined", create_combined_method },
+    { "bisection", create_bisection_method },
+    { "halley", create_halley_method },
+    { "auto", create_auto_method }
+};
+const int root_finder_registry_size = sizeof(root_finder_registry) / sizeof(root_finder_registry[0]);
+
+const IntegratorEntry integrator_registry[] = {
+    { "simpson", create_simpson_method },
+    { "adaptive", create_adaptive_simpson_method },
+    { "auto", create_auto_integrator }
+};
+const int integrator_registry_size = sizeof(integrator_registry) / sizeof(integrator_registry[0]);
+
+bool create_root_finder_by_name(const char* key, RootFinder* out) {
+    for (int i = 0; i < root_finder_registry_size; i++) {
+        if (strcmp(root_finder_registry[i].key, key) == 0) {
+            *out = root_finder_registry[i].create();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool create_integrator_by_name(const char* key, Integrator* out) {
+    for (int i = 0; i < integrator_registry_size; i++) {
+        if (strcmp(integrator_registry[i].key, key) == 0) {
+            *out = integrator_registry[i].create();
+            return true;
+        }
+    }
+    return false;
+}
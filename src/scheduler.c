@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "declarations.h"
+#include "scheduler.h"
+
+// Дека Чейза-Лева фиксированного размера.
+// bottom меняет только владелец, top - владелец и воры через CAS
+typedef struct {
+    long top;
+    long bottom;
+    Task* buffer[DEQUE_CAPACITY];
+} Deque;
+
+typedef struct {
+    Deque deque;
+    Scheduler* sched;
+    pthread_t thread;
+    int index;
+    unsigned seed;   // Для выбора жертвы при краже
+} Worker;
+
+struct Scheduler {
+    Worker* workers;
+    int threads;
+    long pending;    // Незавершенные задачи текущего scheduler_run
+    int running;
+    int shutdown;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+};
+
+// Рабочий поток, в котором выполняется текущая задача
+static __thread Worker* current_worker = NULL;
+
+static int deque_push(Deque* dq, Task* task) {
+    long b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+    long t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+
+    if (b - t >= DEQUE_CAPACITY) {
+        return 0;
+    }
+
+    dq->buffer[b & (DEQUE_CAPACITY - 1)] = task;
+    __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static Task* deque_pop(Deque* dq) {
+    long b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&dq->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+
+    if (t > b) {
+        // Дека пуста
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    Task* task = dq->buffer[b & (DEQUE_CAPACITY - 1)];
+    if (t == b) {
+        // Последний элемент: соревнуемся с ворами
+        if (!__atomic_compare_exchange_n(&dq->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            task = NULL;
+        }
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+    }
+
+    return task;
+}
+
+static Task* deque_steal(Deque* dq) {
+    long t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long b = __atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE);
+
+    if (t >= b) {
+        return NULL;
+    }
+
+    Task* task = dq->buffer[t & (DEQUE_CAPACITY - 1)];
+    if (!__atomic_compare_exchange_n(&dq->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return NULL;  // Задачу забрал кто-то другой
+    }
+
+    return task;
+}
+
+// Своя дека, затем попытка кражи у случайного потока
+static Task* find_task(Worker* w) {
+    Task* task = deque_pop(&w->deque);
+    if (task || w->sched->threads == 1) {
+        return task;
+    }
+
+    int threads = w->sched->threads;
+    w->seed = w->seed * 1103515245u + 12345u;
+    int start = (int)((w->seed >> 16) % (unsigned)threads);
+
+    for (int i = 0; i < threads; i++) {
+        int victim = (start + i) % threads;
+        if (victim == w->index) continue;
+
+        task = deque_steal(&w->sched->workers[victim].deque);
+        if (task) return task;
+    }
+
+    return NULL;
+}
+
+static void execute(Worker* w, Task* task) {
+    task->run(task, w->sched);
+    __atomic_sub_fetch(&w->sched->pending, 1, __ATOMIC_ACQ_REL);
+}
+
+static void* worker_loop(void* arg) {
+    Worker* w = (Worker*)arg;
+    Scheduler* sched = w->sched;
+    current_worker = w;
+
+    for (;;) {
+        // Между вызовами scheduler_run спим на условной переменной
+        pthread_mutex_lock(&sched->lock);
+        while (!sched->running && !sched->shutdown) {
+            pthread_cond_wait(&sched->wake, &sched->lock);
+        }
+        int stop = sched->shutdown;
+        pthread_mutex_unlock(&sched->lock);
+
+        if (stop) break;
+
+        while (__atomic_load_n(&sched->running, __ATOMIC_ACQUIRE)) {
+            Task* task = find_task(w);
+            if (task) {
+                execute(w, task);
+            } else {
+                sched_yield();
+            }
+        }
+    }
+
+    return NULL;
+}
+
+Scheduler* scheduler_create(int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    Scheduler* sched = (Scheduler*)calloc(1, sizeof(Scheduler));
+    if (!sched) {
+        fprintf(stderr, "Memory allocation failed for Scheduler\n");
+        exit(EXIT_FAILURE);
+    }
+
+    sched->workers = (Worker*)calloc(threads, sizeof(Worker));
+    if (!sched->workers) {
+        fprintf(stderr, "Memory allocation failed for Scheduler workers\n");
+        free(sched);
+        exit(EXIT_FAILURE);
+    }
+
+    sched->threads = threads;
+    pthread_mutex_init(&sched->lock, NULL);
+    pthread_cond_init(&sched->wake, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        sched->workers[i].sched = sched;
+        sched->workers[i].index = i;
+        sched->workers[i].seed = 2654435761u * (unsigned)(i + 1);
+    }
+
+    // Поток 0 - тот, кто вызывает scheduler_run
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&sched->workers[i].thread, NULL, worker_loop, &sched->workers[i]) != 0) {
+            // Работаем с теми потоками, что успели запуститься
+            sched->threads = i;
+            break;
+        }
+    }
+
+    return sched;
+}
+
+void scheduler_destroy(Scheduler* sched) {
+    if (!sched) return;
+
+    pthread_mutex_lock(&sched->lock);
+    sched->shutdown = 1;
+    pthread_cond_broadcast(&sched->wake);
+    pthread_mutex_unlock(&sched->lock);
+
+    for (int i = 1; i < sched->threads; i++) {
+        pthread_join(sched->workers[i].thread, NULL);
+    }
+
+    pthread_mutex_destroy(&sched->lock);
+    pthread_cond_destroy(&sched->wake);
+    free(sched->workers);
+    free(sched);
+}
+
+void scheduler_spawn(Scheduler* sched, Task* task) {
+    Worker* w = current_worker;
+
+    if (!w || w->sched != sched) {
+        // Вызов вне задач этого планировщика - просто выполняем
+        task->run(task, sched);
+        return;
+    }
+
+    __atomic_add_fetch(&sched->pending, 1, __ATOMIC_ACQ_REL);
+    if (!deque_push(&w->deque, task)) {
+        __atomic_sub_fetch(&sched->pending, 1, __ATOMIC_ACQ_REL);
+        task->run(task, sched);
+    }
+}
+
+void scheduler_run(Scheduler* sched, Task* root) {
+    Worker* w = &sched->workers[0];
+    Worker* saved = current_worker;
+    current_worker = w;
+
+    __atomic_store_n(&sched->pending, 1, __ATOMIC_RELEASE);
+    deque_push(&w->deque, root);
+
+    pthread_mutex_lock(&sched->lock);
+    __atomic_store_n(&sched->running, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&sched->wake);
+    pthread_mutex_unlock(&sched->lock);
+
+    while (__atomic_load_n(&sched->pending, __ATOMIC_ACQUIRE) > 0) {
+        Task* task = find_task(w);
+        if (task) {
+            execute(w, task);
+        } else {
+            sched_yield();
+        }
+    }
+
+    pthread_mutex_lock(&sched->lock);
+    __atomic_store_n(&sched->running, 0, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&sched->lock);
+
+    current_worker = saved;
+}
+
+int scheduler_threads(const Scheduler* sched) {
+    return sched->threads;
+}
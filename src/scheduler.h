@@ -0,0 +1,30 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+// Планировщик с перехватом работы: у каждого потока своя дека Чейза-Лева,
+// свои задачи поток берет с хвоста, чужие забирает с головы
+
+#define DEQUE_CAPACITY 4096   // Степень двойки
+
+typedef struct Scheduler Scheduler;
+typedef struct Task Task;
+
+// Задача встраивается в структуру с данными (первым полем) и не копируется:
+// память под задачу принадлежит тому, кто ее породил
+struct Task {
+    void (*run)(Task* task, Scheduler* sched);
+};
+
+Scheduler* scheduler_create(int threads);
+void scheduler_destroy(Scheduler* sched);
+
+// Выполняет root и все порожденные им задачи; возвращается, когда все они завершены
+void scheduler_run(Scheduler* sched, Task* root);
+
+// Добавляет задачу в деку текущего потока (вызывать только из задач).
+// Если дека заполнена, задача выполняется сразу в текущем потоке
+void scheduler_spawn(Scheduler* sched, Task* task);
+
+int scheduler_threads(const Scheduler* sched);
+
+#endif
@@ -0,0 +1,517 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include "server.h"
+
+// Общее состояние сервера. Счетчики меняются атомарно из рабочих потоков.
+// Соединения без данных ждут в poll у диспетчера; рабочим передается
+// соединение с пришедшим запросом, и после ответа оно возвращается
+// диспетчеру. Так простаивающие клиенты не занимают рабочих
+typedef struct {
+    int listen_fd;
+    int wake[2];          // Рабочие будят диспетчер после каждого запроса
+    RootFinder* rf;
+    Integrator* integ;
+    ResultCache* cache;
+    int stop;
+
+    unsigned long requests;
+    unsigned long errors;
+    unsigned long latency[SERVER_LATENCY_BUCKETS];
+
+    // Соединения диспетчера, без блокировки
+    int idle[SERVER_MAX_CONNECTIONS];
+    int idle_count;
+    int open_count;       // Все открытые соединения, под lock
+    struct pollfd fds[SERVER_MAX_CONNECTIONS + 2];
+
+    // Очереди между диспетчером и рабочими, под lock
+    pthread_mutex_t lock;
+    pthread_cond_t ready_cond;
+    int ready[SERVER_MAX_CONNECTIONS];     // С запросом, ждут рабочего
+    int ready_head;
+    int ready_count;
+    int returned[SERVER_MAX_CONNECTIONS];  // Обслужены, снова ждут данных
+    int returned_count;
+} Server;
+
+// Последовательное чтение полей тела запроса
+typedef struct {
+    const unsigned char* data;
+    uint32_t length;
+    uint32_t offset;
+} Reader;
+
+static int read_i32(Reader* r, int32_t* value) {
+    if (r->length - r->offset < sizeof(*value)) return 0;
+    memcpy(value, r->data + r->offset, sizeof(*value));
+    r->offset += sizeof(*value);
+    return 1;
+}
+
+static int read_double(Reader* r, double* value) {
+    if (r->length - r->offset < sizeof(*value)) return 0;
+    memcpy(value, r->data + r->offset, sizeof(*value));
+    r->offset += sizeof(*value);
+    return 1;
+}
+
+static uint32_t write_bytes(unsigned char* out, uint32_t offset, const void* value, size_t size) {
+    memcpy(out + offset, value, size);
+    return offset + (uint32_t)size;
+}
+
+static int read_full(int fd, void* buffer, size_t size) {
+    unsigned char* p = (unsigned char*)buffer;
+
+    while (size > 0) {
+        ssize_t n = recv(fd, p, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        size -= (size_t)n;
+    }
+
+    return 1;
+}
+
+static int write_full(int fd, const void* buffer, size_t size) {
+    const unsigned char* p = (const unsigned char*)buffer;
+
+    while (size > 0) {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        size -= (size_t)n;
+    }
+
+    return 1;
+}
+
+static double elapsed_ns(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e9 + (now.tv_nsec - start->tv_nsec);
+}
+
+// Гистограмма задержек по степеням двойки: корзина k - [2^k, 2^(k+1)) нс
+static void record_latency(Server* server, double ns) {
+    int bucket = 0;
+    while (bucket < SERVER_LATENCY_BUCKETS - 1 && ns >= ldexp(2.0, bucket)) {
+        bucket++;
+    }
+    __atomic_add_fetch(&server->latency[bucket], 1, __ATOMIC_RELAXED);
+}
+
+// Квантиль по гистограмме - верхняя граница корзины, в микросекундах
+static double latency_quantile(Server* server, double q) {
+    unsigned long counts[SERVER_LATENCY_BUCKETS];
+    unsigned long total = 0;
+
+    for (int k = 0; k < SERVER_LATENCY_BUCKETS; k++) {
+        counts[k] = __atomic_load_n(&server->latency[k], __ATOMIC_RELAXED);
+        total += counts[k];
+    }
+
+    if (total == 0) return 0.0;
+
+    unsigned long rank = (unsigned long)(q * total);
+    if (rank >= total) rank = total - 1;
+
+    unsigned long seen = 0;
+    for (int k = 0; k < SERVER_LATENCY_BUCKETS; k++) {
+        seen += counts[k];
+        if (seen > rank) return ldexp(2.0, k) / 1000.0;
+    }
+
+    return ldexp(2.0, SERVER_LATENCY_BUCKETS - 1) / 1000.0;
+}
+
+// Кривые фигуры по номерам из запроса
+static int read_figure(Reader* r, Figure* fig, double* eps) {
+    int32_t ids[3];
+    Function curves[3];
+    double a, b;
+
+    for (int i = 0; i < 3; i++) {
+        if (!read_i32(r, &ids[i]) || !lookup_curve(ids[i], &curves[i])) return 0;
+    }
+    if (!read_double(r, &a) || !read_double(r, &b) || !read_double(r, eps)) return 0;
+    if (ids[0] == ids[1] || ids[0] == ids[2] || ids[1] == ids[2]) return 0;
+    if (!(b > a) || !(*eps > 0)) return 0;
+
+    *fig = create_figure(curves[0], curves[1], curves[2], a, b);
+    return 1;
+}
+
+// Выполняет запрос, заполняет тело ответа. Возвращает статус ответа
+static uint32_t handle_request(Server* server, uint32_t type, Reader* r,
+                               unsigned char* out, uint32_t* out_length) {
+    Figure fig;
+    double eps;
+    *out_length = 0;
+
+    switch (type) {
+        case SERVER_AREA: {
+            if (!read_figure(r, &fig, &eps)) return SERVER_BAD_REQUEST;
+
+            double area = cache_calculate_area(server->cache, &fig, eps, server->rf, server->integ);
+            if (area < 0) return SERVER_FAILED;
+
+            *out_length = write_bytes(out, 0, &area, sizeof(area));
+            return SERVER_OK;
+        }
+        case SERVER_ROOTS: {
+            if (!read_figure(r, &fig, &eps) || !(eps <= SERVER_MAX_ROOT_EPS)) return SERVER_BAD_REQUEST;
+
+            CacheKey key;
+            cache_roots_key(&fig, eps, server->rf, &key);
+            CachedResult roots;
+            if (!server->cache || !cache_get(server->cache, &key, &roots)) {
+                // В кэш попадают только сошедшиеся корни всех трех пар
+                SolveResult solved[3];
+                for (int pair = 0; pair < 3; pair++) {
+                    solve_intersection_result(&fig, pair, eps, server->rf, &solved[pair]);
+                    if (solved[pair].status != SOLVE_CONVERGED) return SERVER_FAILED;
+                    roots.values[pair] = solved[pair].root;
+                }
+                roots.count = 3;
+                sort_points(roots.values, roots.count);
+                if (server->cache) cache_put(server->cache, &key, &roots);
+            }
+
+            int32_t n = roots.count;
+            uint32_t offset = write_bytes(out, 0, &n, sizeof(n));
+            for (int i = 0; i < roots.count; i++) {
+                offset = write_bytes(out, offset, &roots.values[i], sizeof(roots.values[i]));
+            }
+            *out_length = offset;
+            return SERVER_OK;
+        }
+        case SERVER_INTEGRAL: {
+            int32_t id;
+            Function f;
+            double a, b;
+
+            if (!read_i32(r, &id) || !lookup_curve(id, &f) ||
+                !read_double(r, &a) || !read_double(r, &b) || !read_double(r, &eps) || !(eps > 0)) {
+                return SERVER_BAD_REQUEST;
+            }
+
+            double value = cache_integrate(server->cache, &f, a, b, eps, server->integ);
+            *out_length = write_bytes(out, 0, &value, sizeof(value));
+            return SERVER_OK;
+        }
+        case SERVER_STATS: {
+            uint64_t requests = __atomic_load_n(&server->requests, __ATOMIC_RELAXED);
+            uint64_t errors = __atomic_load_n(&server->errors, __ATOMIC_RELAXED);
+            double p50 = latency_quantile(server, 0.50);
+            double p99 = latency_quantile(server, 0.99);
+
+            uint32_t offset = write_bytes(out, 0, &requests, sizeof(requests));
+            offset = write_bytes(out, offset, &errors, sizeof(errors));
+            uint64_t hits = 0, misses = 0;
+            uint32_t entries = 0;
+            if (server->cache) cache_stats(server->cache, &hits, &misses, &entries);
+
+            offset = write_bytes(out, offset, &p50, sizeof(p50));
+            offset = write_bytes(out, offset, &p99, sizeof(p99));
+            offset = write_bytes(out, offset, &hits, sizeof(hits));
+            *out_length = write_bytes(out, offset, &misses, sizeof(misses));
+            return SERVER_OK;
+        }
+        case SERVER_SHUTDOWN:
+            return SERVER_OK;
+        default:
+            return SERVER_BAD_REQUEST;
+    }
+}
+
+static void wake_dispatcher(Server* server) {
+    char byte = 0;
+    // Канал неблокирующий: если он полон, диспетчер и так проснется
+    if (write(server->wake[1], &byte, 1) < 0) {
+        return;
+    }
+}
+
+// Один запрос с соединения, где poll уже увидел данные. Возвращает 1,
+// если соединение можно вернуть диспетчеру, 0 - если его нужно закрыть
+static int serve_request(Server* server, int fd) {
+    unsigned char payload[SERVER_MAX_PAYLOAD];
+    unsigned char out[SERVER_MAX_PAYLOAD];
+    uint32_t header[2];
+
+    // Запрос читается целиком; зависший посреди запроса клиент
+    // отключается по SO_RCVTIMEO
+    if (!read_full(fd, header, sizeof(header))) return 0;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // Тело больше допустимого не читаем: поток рассинхронизирован
+    if (header[1] > SERVER_MAX_PAYLOAD) {
+        uint32_t response[2] = { SERVER_BAD_REQUEST, 0 };
+        __atomic_add_fetch(&server->errors, 1, __ATOMIC_RELAXED);
+        write_full(fd, response, sizeof(response));
+        return 0;
+    }
+    if (!read_full(fd, payload, header[1])) return 0;
+
+    Reader reader = { payload, header[1], 0 };
+    uint32_t response[2];
+    response[0] = handle_request(server, header[0], &reader, out, &response[1]);
+
+    __atomic_add_fetch(&server->requests, 1, __ATOMIC_RELAXED);
+    if (response[0] != SERVER_OK) {
+        __atomic_add_fetch(&server->errors, 1, __ATOMIC_RELAXED);
+    }
+    record_latency(server, elapsed_ns(&start));
+
+    if (!write_full(fd, response, sizeof(response)) || !write_full(fd, out, response[1])) return 0;
+
+    if (header[0] == SERVER_SHUTDOWN) {
+        __atomic_store_n(&server->stop, 1, __ATOMIC_RELEASE);
+        return 0;
+    }
+    return 1;
+}
+
+// Рабочий берет из очереди соединение с запросом, отвечает на один
+// запрос и отдает соединение обратно диспетчеру
+static void* worker_loop(void* arg) {
+    Server* server = (Server*)arg;
+
+    for (;;) {
+        pthread_mutex_lock(&server->lock);
+        while (server->ready_count == 0 && !__atomic_load_n(&server->stop, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&server->ready_cond, &server->lock);
+        }
+        if (server->ready_count == 0) {
+            pthread_mutex_unlock(&server->lock);
+            return NULL;
+        }
+        int fd = server->ready[server->ready_head];
+        server->ready_head = (server->ready_head + 1) % SERVER_MAX_CONNECTIONS;
+        server->ready_count--;
+        pthread_mutex_unlock(&server->lock);
+
+        int keep = serve_request(server, fd);
+
+        pthread_mutex_lock(&server->lock);
+        if (keep && !__atomic_load_n(&server->stop, __ATOMIC_ACQUIRE)) {
+            server->returned[server->returned_count++] = fd;
+        } else {
+            close(fd);
+            server->open_count--;
+        }
+        pthread_mutex_unlock(&server->lock);
+
+        wake_dispatcher(server);
+    }
+}
+
+static void accept_connection(Server* server) {
+    int fd = accept(server->listen_fd, NULL, NULL);
+    if (fd < 0) {
+        return;  // EINTR, ECONNABORTED и т.п.: poll сообщит снова
+    }
+
+    struct timeval timeout = { SERVER_REQUEST_TIMEOUT_MS / 1000, (SERVER_REQUEST_TIMEOUT_MS % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    pthread_mutex_lock(&server->lock);
+    server->open_count++;
+    pthread_mutex_unlock(&server->lock);
+    server->idle[server->idle_count++] = fd;
+}
+
+// Диспетчер: poll по сокету приема, каналу пробуждения и простаивающим
+// соединениям. При SERVER_MAX_CONNECTIONS открытых соединений новые
+// ждут в очереди listen
+static void dispatch_loop(Server* server) {
+    while (!__atomic_load_n(&server->stop, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&server->lock);
+        int accepting = server->open_count < SERVER_MAX_CONNECTIONS;
+        pthread_mutex_unlock(&server->lock);
+
+        server->fds[0] = (struct pollfd){ server->wake[0], POLLIN, 0 };
+        server->fds[1] = (struct pollfd){ server->listen_fd, accepting ? POLLIN : 0, 0 };
+        for (int i = 0; i < server->idle_count; i++) {
+            server->fds[i + 2] = (struct pollfd){ server->idle[i], POLLIN, 0 };
+        }
+
+        if (poll(server->fds, (nfds_t)server->idle_count + 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        // Соединения с данными (или закрытые клиентом) - в очередь рабочим
+        int kept = 0;
+        pthread_mutex_lock(&server->lock);
+        for (int i = 0; i < server->idle_count; i++) {
+            if (server->fds[i + 2].revents) {
+                int tail = (server->ready_head + server->ready_count) % SERVER_MAX_CONNECTIONS;
+                server->ready[tail] = server->idle[i];
+                server->ready_count++;
+                pthread_cond_signal(&server->ready_cond);
+            } else {
+                server->idle[kept++] = server->idle[i];
+            }
+        }
+        server->idle_count = kept;
+
+        if (server->fds[0].revents) {
+            char drain[64];
+            while (read(server->wake[0], drain, sizeof(drain)) > 0) {
+            }
+            for (int i = 0; i < server->returned_count; i++) {
+                server->idle[server->idle_count++] = server->returned[i];
+            }
+            server->returned_count = 0;
+        }
+        pthread_mutex_unlock(&server->lock);
+
+        if (server->fds[1].revents & POLLIN) {
+            accept_connection(server);
+        }
+    }
+}
+
+static int open_socket(const char* path) {
+    struct sockaddr_un addr;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Error: Socket path is too long: %s\n", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    // Сокет от предыдущего запуска мешает bind. Удаляется только сокет:
+    // обычный файл на этом пути - скорее опечатка в --serve
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "Error: %s exists and is not a socket\n", path);
+            close(fd);
+            return -1;
+        }
+        if (unlink(path) != 0) {
+            perror(path);
+            close(fd);
+            return -1;
+        }
+    } else if (errno != ENOENT) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static int open_wake_pipe(int wake[2]) {
+    if (pipe(wake) != 0) {
+        perror("pipe");
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(wake[i], F_SETFL, fcntl(wake[i], F_GETFL) | O_NONBLOCK);
+    }
+    return 0;
+}
+
+int run_server(const char* path, int workers, RootFinder* rf, Integrator* integ, ResultCache* cache) {
+    static Server server;
+    pthread_t threads[MAX_THREADS];
+    int started = 0;
+
+    if (workers < 1) workers = SERVER_DEFAULT_WORKERS;
+    if (workers > MAX_THREADS) workers = MAX_THREADS;
+
+    memset(&server, 0, sizeof(server));
+    server.listen_fd = open_socket(path);
+    if (server.listen_fd < 0) {
+        return -1;
+    }
+    if (open_wake_pipe(server.wake) != 0) {
+        close(server.listen_fd);
+        unlink(path);
+        return -1;
+    }
+
+    server.rf = rf;
+    server.integ = integ;
+    server.cache = cache;
+    pthread_mutex_init(&server.lock, NULL);
+    pthread_cond_init(&server.ready_cond, NULL);
+
+    for (int i = 0; i < workers; i++) {
+        if (pthread_create(&threads[started], NULL, worker_loop, &server) != 0) {
+            break;
+        }
+        started++;
+    }
+    if (started == 0) {
+        fprintf(stderr, "Error: Could not start server workers\n");
+        __atomic_store_n(&server.stop, 1, __ATOMIC_RELEASE);
+    } else {
+        fprintf(stderr, "Serving on %s with %d workers\n", path, started);
+    }
+
+    // Вызывающий поток - диспетчер
+    dispatch_loop(&server);
+
+    // Остановка: будим рабочих, ждущих очереди, и закрываем все соединения
+    pthread_mutex_lock(&server.lock);
+    __atomic_store_n(&server.stop, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&server.ready_cond);
+    pthread_mutex_unlock(&server.lock);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (int i = 0; i < server.idle_count; i++) close(server.idle[i]);
+    for (int i = 0; i < server.returned_count; i++) close(server.returned[i]);
+    for (int i = 0; i < server.ready_count; i++) {
+        close(server.ready[(server.ready_head + i) % SERVER_MAX_CONNECTIONS]);
+    }
+
+    close(server.wake[0]);
+    close(server.wake[1]);
+    close(server.listen_fd);
+    unlink(path);
+    pthread_cond_destroy(&server.ready_cond);
+    pthread_mutex_destroy(&server.lock);
+    return started > 0 ? 0 : -1;
+}
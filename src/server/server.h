@@ -0,0 +1,51 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdint.h>
+
+#include "../declarations.h"
+#include "../cache/cache.h"
+
+// Серверный режим: долгоживущий процесс на Unix-сокете.
+// Запрос и ответ - заголовок из двух uint32 (тип/статус и длина тела)
+// и тело из полей в порядке байтов хоста (сокет локальный).
+//
+//   SERVER_AREA      int32 f1, f2, f3; double a, b, eps -> double area
+//   SERVER_ROOTS     int32 f1, f2, f3; double a, b, eps -> int32 count; double points[count]
+//   SERVER_INTEGRAL  int32 f; double a, b, eps          -> double value
+//   SERVER_STATS     пусто -> uint64 requests, errors; double p50_us, p99_us;
+//                    uint64 cache_hits, cache_misses
+//   SERVER_SHUTDOWN  пусто -> пусто, сервер завершается
+//
+// eps в SERVER_ROOTS - допуск решателя: по ширине отрезка и по |f - g|,
+// не больше SERVER_MAX_ROOT_EPS. Если хотя бы одна из трех точек
+// пересечения не найдена, ответ SERVER_FAILED.
+//
+// Соединение обслуживает любое число запросов подряд. Между запросами
+// соединение не занимает рабочего, но сам запрос должен прийти целиком
+// за SERVER_REQUEST_TIMEOUT_MS, иначе соединение закрывается
+
+#define SERVER_AREA 1
+#define SERVER_ROOTS 2
+#define SERVER_INTEGRAL 3
+#define SERVER_STATS 4
+#define SERVER_SHUTDOWN 5
+
+#define SERVER_OK 0
+#define SERVER_BAD_REQUEST 1
+#define SERVER_FAILED 2
+
+#define SERVER_MAX_PAYLOAD 256
+#define SERVER_DEFAULT_WORKERS 4
+#define SERVER_MAX_CONNECTIONS 256
+#define SERVER_REQUEST_TIMEOUT_MS 1000
+#define SERVER_MAX_ROOT_EPS 1e-3
+#define SERVER_LATENCY_BUCKETS 40   // Степени двойки наносекунд
+
+// Ответы на AREA, ROOTS и INTEGRAL берутся из cache (NULL - без кэша).
+// Блокирует вызывающий поток до запроса SERVER_SHUTDOWN.
+// Существующий путь заменяется, только если это сокет.
+// Возвращает 0 при штатном завершении, -1 если сокет не создан
+int run_server(const char* path, int workers, RootFinder* rf, Integrator* integ, ResultCache* cache);
+
+#endif
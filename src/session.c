@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <math.h>
+
+#include "declarations.h"
+
+void area_session_init(AreaSession* s, Figure* fig, RootFinder* rf) {
+    s->fig = fig;
+    s->rf = rf;
+    s->root_eps = 0.0;
+    s->segments = 0;
+    s->root_generation = 0;
+    s->edges_generation = -1;
+    s->edges_eps = 0.0;
+    s->root_iterations = 0;
+    s->evaluations = 0;
+}
+
+// Грубый корень пары: в первый раз - как в solve_intersection, затем -
+// только на итоговом отрезке прошлого решения
+static void coarse_root(AreaSession* s, int pair, double coarse_eps) {
+    SolveResult* root = &s->roots[pair];
+
+    if (s->root_eps > 0 && root->status == SOLVE_CONVERGED) {
+        Function* f;
+        Function* g;
+        get_pair_functions(s->fig, pair, &f, &g);
+
+        SolveResult refined;
+        s->rf->solve_result(f, g, root->lo, root->hi, coarse_eps, &refined);
+        if (refined.status == SOLVE_CONVERGED) {
+            s->root_iterations += refined.iterations;
+            *root = refined;
+            return;
+        }
+    }
+
+    solve_intersection_result(s->fig, pair, coarse_eps, s->rf, root);
+    s->root_iterations += root->iterations;
+}
+
+// Корни с ошибкой площади не больше доли eps, как в calculate_area:
+// грубый проход задает сегменты, и каждый корень уточняется до своей доли
+static void refine_roots(AreaSession* s, double eps) {
+    double eps_root, eps2;
+    split_area_tolerance(eps, &eps_root, &eps2);
+
+    double coarse[3];
+    for (int pair = 0; pair < 3; pair++) {
+        coarse_root(s, pair, area_coarse_eps(eps_root));
+        coarse[pair] = s->roots[pair].root;
+    }
+    sort_points(coarse, 3);
+
+    for (int pair = 0; pair < 3; pair++) {
+        int before = s->roots[pair].iterations;
+        refine_area_root(s->fig, pair, coarse, eps_root, s->rf, &s->roots[pair]);
+        s->root_iterations += s->roots[pair].iterations - before;
+        s->points[pair] = s->roots[pair].root;
+    }
+    sort_points(s->points, 3);
+    s->root_eps = eps;
+    s->root_generation++;
+}
+
+// Интеграл разности по отрезку между краем сетки и новым положением
+// корня: отрезок делится, пока оценка Ричардсона не станет меньше tol
+static double edge_correction(AreaSession* s, Function* diff, double from, double to, double tol) {
+    if (!(from < to) && !(from > to)) return 0.0;
+
+    double sign = 1.0;
+    if (from > to) {
+        double t = from;
+        from = to;
+        to = t;
+        sign = -1.0;
+    }
+
+    SimpsonState state;
+    simpson_start(&state, diff, from, to);
+    do {
+        simpson_refine(&state);
+    } while (simpson_error(&state) > tol && state.level < SIMPSON_MAX_LEVEL);
+
+    s->evaluations += state.evaluations;
+    return sign * state.result;
+}
+
+// Сетка сегмента между текущими корнями
+static void build_segment(AreaSession* s, int i) {
+    select_segment_bounds(s->fig, (s->points[i] + s->points[i + 1]) / 2, &s->pairs[i]);
+    s->diffs[i] = create_difference_function(&s->pairs[i]);
+    simpson_start(&s->states[i], &s->diffs[i], s->points[i], s->points[i + 1]);
+    simpson_refine(&s->states[i]);
+    s->evaluations += s->states[i].evaluations;
+
+    double eps_root, eps2;
+    split_area_tolerance(s->root_eps, &eps_root, &eps2);
+    s->grid_eps[i] = area_coarse_eps(eps_root);
+}
+
+// Сетку нельзя оставить, если на новом отрезке фигуру ограничивает другая
+// пара кривых (корень ушел из прежнего сегмента) или край сдвинулся
+// дальше, чем позволяла точность корней, по которым сетка строилась
+static bool segment_stale(AreaSession* s, int i) {
+    FunctionPair pair;
+    select_segment_bounds(s->fig, (s->points[i] + s->points[i + 1]) / 2, &pair);
+    if (pair.upper != s->pairs[i].upper || pair.lower != s->pairs[i].lower) {
+        return true;
+    }
+
+    return fabs(s->points[i] - s->states[i].a) > s->grid_eps[i] ||
+           fabs(s->points[i + 1] - s->states[i].b) > s->grid_eps[i];
+}
+
+double area_session_area(AreaSession* s, double eps) {
+    if (s->root_eps <= 0 || eps < s->root_eps) {
+        refine_roots(s, eps);
+    }
+    if (!area_roots_converged(s->roots)) {
+        return -1.0;
+    }
+
+    if (s->segments == 0) {
+        s->segments = 2;
+        for (int i = 0; i < s->segments; i++) {
+            build_segment(s, i);
+        }
+    } else if (s->edges_generation != s->root_generation) {
+        for (int i = 0; i < s->segments; i++) {
+            if (segment_stale(s, i)) {
+                build_segment(s, i);
+            }
+        }
+    }
+
+    // Доля сегмента делится пополам между сеткой и двумя краями.
+    // Края пересчитываются после уточнения корней и при меньшем eps
+    double eps_root, eps2;
+    split_area_tolerance(eps, &eps_root, &eps2);
+
+    if (s->edges_generation != s->root_generation || eps < s->edges_eps) {
+        double tol = eps2 / 4;
+        for (int i = 0; i < s->segments; i++) {
+            s->edges[i] = edge_correction(s, &s->diffs[i], s->points[i], s->states[i].a, tol)
+                        + edge_correction(s, &s->diffs[i], s->states[i].b, s->points[i + 1], tol);
+        }
+        s->edges_generation = s->root_generation;
+        s->edges_eps = eps;
+    }
+
+    double area = 0.0;
+
+    for (int i = 0; i < s->segments; i++) {
+        SimpsonState* state = &s->states[i];
+
+        while (simpson_error(state) > eps2 / 2 && state->level < SIMPSON_MAX_LEVEL) {
+            int before = state->evaluations;
+            simpson_refine(state);
+            s->evaluations += state->evaluations - before;
+        }
+
+        area += state->result + s->edges[i];
+    }
+
+    return area;
+}
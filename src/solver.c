@@ -2,43 +2,67 @@
 #include <math.h>
 
 #include "declarations.h"
+#include "trace/trace.h"
 
-// Метод деления отрезка пополам
-static double bisection_solve(Function* f, Function* g, double a, double b, double eps, int* iterations) {
-    *iterations = 0;
+// Число отрезков, которые пакетный решатель ведет одновременно
+#define BATCH_LANES 32
+
+// Все ядра решателей не пишут в stdout и не выделяют память: итог
+// и диагностика возвращаются в SolveResult, печатает их вызывающий код
+
+// Заполнение результата
+static inline void set_result(SolveResult* res, double root, SolveStatus status, double lo, double hi) {
+    res->root = root;
+    res->status = status;
+    res->lo = lo;
+    res->hi = hi;
+}
+
+// Подготовка отрезка для всех методов: обработка случая a = b и поиск
+// подотрезка со сменой знака. Возвращает 0, если решать дальше нечего
+// (результат уже записан в res)
+static inline int prepare_bracket(Function* f, Function* g, double* a, double* b,
+                                  double* fa, double* fb, double eps, SolveResult* res) {
+    res->iterations = 0;
+    res->flags = 0;
     
     // Проверяем случай a = b
-    if (fabs(a - b) < eps) {
-        double fa = evaluate(f, a) - evaluate(g, a);
-        if (fabs(fa) < eps) {
-            return a; // a является корнем
-        }
-        fprintf(stdout, "Warning: a = b and no root found at x = %.6f\n", a);
-        return a;
+    if (fabs(*a - *b) < eps) {
+        *fa = evaluate(f, *a) - evaluate(g, *a);
+        *fb = *fa;
+        res->fa = *fa;
+        res->fb = *fb;
+        // a является корнем, если разность в нем мала
+        set_result(res, *a, (fabs(*fa) < eps) ? SOLVE_CONVERGED : SOLVE_EMPTY_INTERVAL, *a, *b);
+        return 0;
     }
     
-    double fa = evaluate(f, a) - evaluate(g, a);
-    double fb = evaluate(f, b) - evaluate(g, b);
+    // Функция разности f(x) - g(x)
+    *fa = evaluate(f, *a) - evaluate(g, *a);
+    *fb = evaluate(f, *b) - evaluate(g, *b);
+    res->fa = *fa;
+    res->fb = *fb;
     
     // Проверяем, что на концах отрезка функция имеет разные знаки
-    if (fa * fb >= 0) {
-        fprintf(stdout, "Warning: Function values at endpoints have the same sign (f(a) = %.6f, f(b) = %.6f)\n", fa, fb);
+    if (*fa * *fb >= 0) {
+        res->flags |= SOLVE_FLAG_BRACKET_RESCANNED;
+        
         // Попробуем найти подходящий отрезок
-        double step = (b - a) / 10.0;
-        double x = a + step;
+        double step = (*b - *a) / 10.0;
+        double x = *a + step;
         
-        while (x < b) {
+        while (x < *b) {
             double fx = evaluate(f, x) - evaluate(g, x);
-            if (fa * fx < 0) {
+            if (*fa * fx < 0) {
                 // Нашли подходящий отрезок
-                b = x;
-                fb = fx;
+                *b = x;
+                *fb = fx;
                 break;
             }
-            if (fx * fb < 0) {
+            if (fx * *fb < 0) {
                 // Нашли подходящий отрезок
-                a = x;
-                fa = fx;
+                *a = x;
+                *fa = fx;
                 break;
             }
             // Обновляем точку x
@@ -46,105 +70,83 @@ static double bisection_solve(Function* f, Function* g, double a, double b, doub
         }
         
         // Если мы по-прежнему не нашли подходящий отрезок
-        if (fa * fb >= 0) {
-            fprintf(stdout, "Error: Could not find interval with opposite signs\n");
+        if (*fa * *fb >= 0) {
             // Возвращаем точку, где значение функции ближе к нулю
-            return (fabs(fa) < fabs(fb)) ? a : b;
+            set_result(res, (fabs(*fa) < fabs(*fb)) ? *a : *b, SOLVE_NO_SIGN_CHANGE, *a, *b);
+            return 0;
         }
     }
     
-    double c, fc;
+    return 1;
+}
+
+// Метод деления отрезка пополам
+static inline void bisection_core(Function* f, Function* g, double a, double b, double eps, SolveResult* res) {
+    double fa, fb;
+    if (!prepare_bracket(f, g, &a, &b, &fa, &fb, eps, res)) {
+        return;
+    }
+    unsigned run = TRACE_BEGIN();
     
-    while (*iterations < 1000) {
+    while (res->iterations < 1000) {
         // Находим середину отрезка
-        c = (a + b) / 2.0;
-        fc = evaluate(f, c) - evaluate(g, c);
+        double c = (a + b) / 2.0;
+        double fc = evaluate(f, c) - evaluate(g, c);
+        TRACE_RECORD(TRACE_SOLVER, run, res->iterations, c, fc, b - a);
         
         // Проверяем критерии остановки
         if (fabs(fc) < eps || fabs(b - a) < eps) {
-            return c;
+            set_result(res, c, SOLVE_CONVERGED, a, b);
+            return;
         }
         
         // Выбираем новую половину отрезка
         if (fc * fa < 0) {
             b = c;
-            fb = fc;
         } else {
             a = c;
             fa = fc;
         }
         
-        (*iterations)++;
+        res->iterations++;
     }
     
     // Возвращаем середину финального отрезка
-    return (a + b) / 2.0;
+    set_result(res, (a + b) / 2.0, SOLVE_MAX_ITERATIONS, a, b);
 }
 
 // Комбинированный метод хорд и касательных
-static double combined_solve(Function* f, Function* g, double a, double b, double eps, int* iterations) {
-    *iterations = 0;
-    
-    // Проверяем случай a = b
-    if (fabs(a - b) < eps) {
-        double fa = evaluate(f, a) - evaluate(g, a);
-        if (fabs(fa) < eps) {
-            return a; // a является корнем
-        }
-        fprintf(stdout, "Warning: a = b and no root found at x = %.6f\n", a);
-        return a;
-    }
-    
-    // Функция разности f(x) - g(x)
-    double fa = evaluate(f, a) - evaluate(g, a);
-    double fb = evaluate(f, b) - evaluate(g, b);
-    
-    // Проверяем, что на концах отрезка функция имеет разные знаки
-    if (fa * fb >= 0) {
-        fprintf(stdout, "Warning: Function values at endpoints have the same sign (f(a) = %.6f, f(b) = %.6f)\n", fa, fb);
-        // Попробуем найти подходящий отрезок
-        double step = (b - a) / 10.0;
-        double x = a + step;
-        
-        while (x < b) {
-            double fx = evaluate(f, x) - evaluate(g, x);
-            if (fa * fx < 0) {
-                // Нашли подходящий отрезок
-                b = x;
-                fb = fx;
-                break;
-            }
-            if (fx * fb < 0) {
-                // Нашли подходящий отрезок
-                a = x;
-                fa = fx;
-                break;
-            }
-            // Обновляем точку x
-            x += step;
-        }
-        
-        // Если мы по-прежнему не нашли подходящий отрезок
-        if (fa * fb >= 0) {
-            fprintf(stdout, "Error: Could not find interval with opposite signs\n");
-            // Возвращаем точку, где значение функции ближе к нулю
-            return (fabs(fa) < fabs(fb)) ? a : b;
-        }
+static inline void combined_core(Function* f, Function* g, double a, double b, double eps, SolveResult* res) {
+    double fa, fb;
+    if (!prepare_bracket(f, g, &a, &b, &fa, &fb, eps, res)) {
+        return;
     }
+    unsigned run = TRACE_BEGIN();
     
     // Определяем начальные точки для методов
     double x0 = a;  // Для метода касательных
     double x1 = b;  // Для метода хорд
     
-    while (*iterations < 1000) {
+    while (res->iterations < 1000) {
         // Вычисляем значения функции и производной
         double f0 = evaluate(f, x0) - evaluate(g, x0);
         double f1 = evaluate(f, x1) - evaluate(g, x1);
+        TRACE_RECORD(TRACE_SOLVER, run, res->iterations, fabs(f0) < fabs(f1) ? x0 : x1,
+                     fabs(f0) < fabs(f1) ? f0 : f1, fabs(x1 - x0));
         
         // Проверяем, достаточно ли мы близко к корню
-        if (fabs(f0) < eps) return x0;
-        if (fabs(f1) < eps) return x1;
-        if (fabs(x1 - x0) < eps) return (x0 + x1) / 2.0;
+        if (fabs(f0) < eps) {
+            set_result(res, x0, SOLVE_CONVERGED, x0, x1);
+            return;
+        }
+        if (fabs(f1) < eps) {
+            set_result(res, x1, SOLVE_CONVERGED, x0, x1);
+            return;
+        }
+        if (fabs(x1 - x0) < eps) {
+            set_result(res, (x0 + x1) / 2.0, SOLVE_CONVERGED, x0, x1);
+            return;
+        }
         
         // Шаг метода касательных (Ньютона)
         double df0 = evaluate_derivative(f, x0) - evaluate_derivative(g, x0);
@@ -155,6 +157,7 @@ static double combined_solve(Function* f, Function* g, double a, double b, doubl
         } else {
             // Если производная близка к нулю, используем метод хорд вместо касательных
             x_newton = x0 - f0 * (x1 - x0) / (f1 - f0);
+            res->flags |= SOLVE_FLAG_DERIVATIVE_VANISHED;
         }
         
         // Шаг метода хорд
@@ -183,20 +186,289 @@ static double combined_solve(Function* f, Function* g, double a, double b, doubl
             x0 = x_new;
         }
         
-        (*iterations)++;
+        res->iterations++;
+    }
+    
+    set_result(res, (x0 + x1) / 2.0, SOLVE_MAX_ITERATIONS, x0, x1);
+}
+
+// Метод Галлея: x' = x - 2*h*h' / (2*h'^2 - h*h''), h = f - g.
+// Кубическая сходимость вблизи корня; шаг за пределы текущего отрезка
+// со сменой знака заменяется делением пополам
+static inline void halley_core(Function* f, Function* g, double a, double b, double eps, SolveResult* res) {
+    double fa, fb;
+    if (!prepare_bracket(f, g, &a, &b, &fa, &fb, eps, res)) {
+        return;
+    }
+    
+    unsigned run = TRACE_BEGIN();
+    
+    // Начинаем с конца, где разность ближе к нулю
+    double x = (fabs(fa) < fabs(fb)) ? a : b;
+    
+    while (res->iterations < 1000) {
+        double h = evaluate(f, x) - evaluate(g, x);
+        TRACE_RECORD(TRACE_SOLVER, run, res->iterations, x, h, b - a);
+        if (fabs(h) < eps) {
+            set_result(res, x, SOLVE_CONVERGED, a, b);
+            return;
+        }
+        
+        // Сужаем отрезок по знаку разности в текущей точке
+        if (h * fa < 0) {
+            b = x;
+        } else {
+            a = x;
+            fa = h;
+        }
+        
+        double dh = evaluate_derivative(f, x) - evaluate_derivative(g, x);
+        double ddh = evaluate_second_derivative(f, x) - evaluate_second_derivative(g, x);
+        double denominator = 2.0 * dh * dh - h * ddh;
+        
+        // Страховка: если шаг вырожден или выходит за отрезок, делим пополам
+        double x_new = (a + b) / 2.0;
+        if (fabs(denominator) > 0.0) {
+            double x_halley = x - 2.0 * h * dh / denominator;
+            if (x_halley > a && x_halley < b) {
+                x_new = x_halley;
+            }
+        } else {
+            res->flags |= SOLVE_FLAG_DERIVATIVE_VANISHED;
+        }
+        
+        res->iterations++;
+        
+        if (fabs(x_new - x) < eps || fabs(b - a) < eps) {
+            set_result(res, x_new, SOLVE_CONVERGED, a, b);
+            return;
+        }
+        x = x_new;
     }
     
-    return (x0 + x1) / 2.0;
+    set_result(res, x, SOLVE_MAX_ITERATIONS, a, b);
+}
+
+// Точки входа RootFinder: полный результат и упрощенный вариант (только корень)
+static void bisection_solve_result(Function* f, Function* g, double a, double b, double eps, SolveResult* res) {
+    bisection_core(f, g, a, b, eps, res);
+}
+
+static void combined_solve_result(Function* f, Function* g, double a, double b, double eps, SolveResult* res) {
+    combined_core(f, g, a, b, eps, res);
+}
+
+static void halley_solve_result(Function* f, Function* g, double a, double b, double eps, SolveResult* res) {
+    halley_core(f, g, a, b, eps, res);
+}
+
+static double bisection_solve(Function* f, Function* g, double a, double b, double eps, int* iterations) {
+    SolveResult res;
+    bisection_core(f, g, a, b, eps, &res);
+    *iterations = res.iterations;
+    return res.root;
+}
+
+static double combined_solve(Function* f, Function* g, double a, double b, double eps, int* iterations) {
+    SolveResult res;
+    combined_core(f, g, a, b, eps, &res);
+    *iterations = res.iterations;
+    return res.root;
+}
+
+static double halley_solve(Function* f, Function* g, double a, double b, double eps, int* iterations) {
+    SolveResult res;
+    halley_core(f, g, a, b, eps, &res);
+    *iterations = res.iterations;
+    return res.root;
+}
+
+// Печать предупреждений по результату решения (вынесена из ядер решателей)
+void print_solve_status(FILE* out, const SolveResult* res) {
+    if (res->status == SOLVE_EMPTY_INTERVAL) {
+        fprintf(out, "Warning: a = b and no root found at x = %.6f\n", res->lo);
+        return;
+    }
+    
+    if (res->flags & SOLVE_FLAG_BRACKET_RESCANNED) {
+        fprintf(out, "Warning: Function values at endpoints have the same sign (f(a) = %.6f, f(b) = %.6f)\n",
+                res->fa, res->fb);
+    }
+    
+    if (res->status == SOLVE_NO_SIGN_CHANGE) {
+        fprintf(out, "Error: Could not find interval with opposite signs\n");
+    } else if (res->status == SOLVE_MAX_ITERATIONS) {
+        fprintf(out, "Warning: Iteration limit reached, bracket width = %.6e\n", res->hi - res->lo);
+    }
+}
+
+// Пакетный метод деления пополам: все отрезки делятся синхронно,
+// кривые вычисляются одним пакетным вызовом на итерацию
+static void bisection_solve_lanes(Function* f, Function* g, const double* a, const double* b, size_t n,
+                                  double eps, double* roots, int* iters) {
+    double lo[BATCH_LANES], hi[BATCH_LANES], flo[BATCH_LANES];
+    double xs[BATCH_LANES], fx[BATCH_LANES], gx[BATCH_LANES];
+    size_t lane[BATCH_LANES];
+    size_t active = 0;
+    
+    // Значения на левых концах
+    evaluate_batch(f, a, fx, n);
+    evaluate_batch(g, a, gx, n);
+    for (size_t i = 0; i < n; i++) {
+        flo[i] = fx[i] - gx[i];
+    }
+    
+    // Значения на правых концах
+    evaluate_batch(f, b, fx, n);
+    evaluate_batch(g, b, gx, n);
+    
+    for (size_t i = 0; i < n; i++) {
+        double fb = fx[i] - gx[i];
+        
+        // Вырожденные отрезки и отрезки без смены знака решаем поштучно
+        if (fabs(a[i] - b[i]) < eps || flo[i] * fb >= 0) {
+            roots[i] = bisection_solve(f, g, a[i], b[i], eps, &iters[i]);
+            continue;
+        }
+        
+        lo[active] = a[i];
+        hi[active] = b[i];
+        flo[active] = flo[i];
+        lane[active] = i;
+        iters[i] = 0;
+        active++;
+    }
+    
+    while (active > 0) {
+        for (size_t k = 0; k < active; k++) {
+            xs[k] = (lo[k] + hi[k]) / 2.0;
+        }
+        
+        evaluate_batch(f, xs, fx, active);
+        evaluate_batch(g, xs, gx, active);
+        
+        // Обновляем отрезки и выбрасываем сошедшиеся
+        size_t kept = 0;
+        for (size_t k = 0; k < active; k++) {
+            size_t i = lane[k];
+            double fc = fx[k] - gx[k];
+            
+            if (fabs(fc) < eps || fabs(hi[k] - lo[k]) < eps || iters[i] >= 1000) {
+                roots[i] = xs[k];
+                continue;
+            }
+            
+            if (fc * flo[k] < 0) {
+                hi[kept] = xs[k];
+                lo[kept] = lo[k];
+                flo[kept] = flo[k];
+            } else {
+                lo[kept] = xs[k];
+                hi[kept] = hi[k];
+                flo[kept] = fc;
+            }
+            lane[kept] = i;
+            iters[i]++;
+            kept++;
+        }
+        active = kept;
+    }
+}
+
+static void bisection_solve_batch(Function* f, Function* g, const double* a, const double* b, size_t n,
+                                  double eps, double* roots, int* iters) {
+    for (size_t start = 0; start < n; start += BATCH_LANES) {
+        size_t count = (n - start < BATCH_LANES) ? n - start : BATCH_LANES;
+        bisection_solve_lanes(f, g, a + start, b + start, count, eps, roots + start, iters + start);
+    }
+}
+
+// Комбинированный метод выбирает шаг по каждому отрезку отдельно,
+// поэтому пакет решается последовательно
+static void combined_solve_batch(Function* f, Function* g, const double* a, const double* b, size_t n,
+                                 double eps, double* roots, int* iters) {
+    for (size_t i = 0; i < n; i++) {
+        roots[i] = combined_solve(f, g, a[i], b[i], eps, &iters[i]);
+    }
 }
 
 // Создаем функцию для инициализации комбинированного метода
 RootFinder create_combined_method(void) {
-    RootFinder rf = { "Combined Chord-Tangent", combined_solve };
+    RootFinder rf = { "Combined Chord-Tangent", combined_solve, combined_solve_batch, combined_solve_result };
+    return rf;
+}
+
+static void halley_solve_batch(Function* f, Function* g, const double* a, const double* b, size_t n,
+                               double eps, double* roots, int* iters) {
+    for (size_t i = 0; i < n; i++) {
+        roots[i] = halley_solve(f, g, a[i], b[i], eps, &iters[i]);
+    }
+}
+
+// Создаем функцию для инициализации метода Галлея
+RootFinder create_halley_method(void) {
+    RootFinder rf = { "Halley", halley_solve, halley_solve_batch, halley_solve_result };
     return rf;
 }
 
 // Создаем функцию для инициализации метода бисекции
 RootFinder create_bisection_method(void) {
-    RootFinder rf = { "Bisection", bisection_solve };
+    RootFinder rf = { "Bisection", bisection_solve, bisection_solve_batch, bisection_solve_result };
+    return rf;
+}
+// Автовыбор метода: для каждого вызова берется метод с наименьшей оценкой
+// числа вызовов кривых до точности eps на [a, b]. Нужно bits = log2((b - a) / eps)
+// двоичных разрядов корня:
+//   бисекция - 2 вызова (f и g) на итерацию, разряд за итерацию;
+//   комбинированный - 10 вызовов (значения на концах и в двух кандидатах,
+//   производные), число верных разрядов удваивается;
+//   Галлей - 6 вызовов (значения, первые и вторые производные), разряды
+//   утраиваются; без вторых производных не рассматривается
+#define AUTO_BISECTION_CALLS 2.0
+#define AUTO_COMBINED_CALLS 10.0
+#define AUTO_HALLEY_CALLS 6.0
+#define AUTO_MAX_BITS 64.0
+
+static RootFinder auto_choice(Function* f, Function* g, double width, double eps) {
+    double bits = (eps > 0 && width > eps) ? log2(width / eps) + 1.0 : 1.0;
+    if (!(eps > 0) || bits > AUTO_MAX_BITS) bits = AUTO_MAX_BITS;
+    
+    double bisection = AUTO_BISECTION_CALLS * bits;
+    double combined = AUTO_COMBINED_CALLS * (log2(bits) + 1.0);
+    double halley = (f->second_derivative && g->second_derivative)
+        ? AUTO_HALLEY_CALLS * (log(bits) / log(3.0) + 1.0)
+        : HUGE_VAL;
+    
+    if (halley < combined && halley < bisection) {
+        return create_halley_method();
+    }
+    return (combined < bisection) ? create_combined_method() : create_bisection_method();
+}
+
+static void auto_solve_result(Function* f, Function* g, double a, double b, double eps, SolveResult* res) {
+    RootFinder rf = auto_choice(f, g, fabs(b - a), eps);
+    rf.solve_result(f, g, a, b, eps, res);
+}
+
+static double auto_solve(Function* f, Function* g, double a, double b, double eps, int* iterations) {
+    RootFinder rf = auto_choice(f, g, fabs(b - a), eps);
+    return rf.solve(f, g, a, b, eps, iterations);
+}
+
+// Для пакета метод один, по самому широкому отрезку
+static void auto_solve_batch(Function* f, Function* g, const double* a, const double* b, size_t n,
+                             double eps, double* roots, int* iters) {
+    double width = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        if (fabs(b[i] - a[i]) > width) width = fabs(b[i] - a[i]);
+    }
+    
+    RootFinder rf = auto_choice(f, g, width, eps);
+    rf.solve_batch(f, g, a, b, n, eps, roots, iters);
+}
+
+// Создаем функцию для инициализации автовыбора метода
+RootFinder create_auto_method(void) {
+    RootFinder rf = { "Auto", auto_solve, auto_solve_batch, auto_solve_result };
     return rf;
-}
\ No newline at end of file
+}
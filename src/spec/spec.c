@@ -0,0 +1,338 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "spec.h"
+#include "../cache/cache.h"
+
+#define SPEC_PATH_LEN 256
+#define SPEC_COMMAND_LEN 2048
+
+static const char* symbol_names[3][3] = {
+    { "f1", "df1", "ddf1" },
+    { "f2", "df2", "ddf2" },
+    { "f3", "df3", "ddf3" }
+};
+
+// Токены строки через один пробел, без пробелов по краям
+static bool normalize_expression(const char* line, char* out, size_t size) {
+    size_t used = 0;
+    const char* p = line;
+    while (*p) {
+        while (isspace((unsigned char)*p)) p++;
+        if (!*p) break;
+
+        if (used > 0) {
+            if (used + 1 >= size) return false;
+            out[used++] = ' ';
+        }
+        while (*p && !isspace((unsigned char)*p)) {
+            if (used + 1 >= size) return false;
+            out[used++] = *p++;
+        }
+    }
+    out[used] = '\0';
+    return used > 0;
+}
+
+bool spec_normalize(const char* path, char* out, size_t size, double* a, double* b) {
+    FILE* in = fopen(path, "r");
+    if (!in) {
+        perror(path);
+        return false;
+    }
+
+    char line[SPEC_MAX_LINE];
+    bool ok = fgets(line, sizeof(line), in) && sscanf(line, "%lf %lf", a, b) == 2;
+    if (!ok) {
+        fprintf(stderr, "Error: Could not read range from spec %s\n", path);
+        fclose(in);
+        return false;
+    }
+
+    int used = snprintf(out, size, "%.17g %.17g\n", *a, *b);
+    for (int i = 0; i < 3 && ok; i++) {
+        char expression[SPEC_MAX_LINE];
+        // Строка без перевода строки допустима только последней в файле,
+        // иначе она не поместилась в буфер
+        ok = fgets(line, sizeof(line), in) && (strchr(line, '\n') != NULL || feof(in))
+            && normalize_expression(line, expression, sizeof(expression));
+        if (!ok) {
+            fprintf(stderr, "Error: Could not read expression %d from spec %s (max %d characters)\n",
+                    i + 1, path, SPEC_MAX_LINE - 2);
+            break;
+        }
+        used += snprintf(out + used, size > (size_t)used ? size - used : 0, "%s\n", expression);
+    }
+    fclose(in);
+
+    if (ok && (size_t)used >= size) {
+        fprintf(stderr, "Error: Spec %s is too long\n", path);
+        return false;
+    }
+    return ok;
+}
+
+uint64_t spec_hash(const char* normalized) {
+    uint64_t hash = CACHE_HASH_SEED;
+    uint32_t version = SPEC_CACHE_VERSION;
+    hash = cache_hash_bytes(hash, &version, sizeof(version));
+    hash = cache_hash_string(hash, SPEC_ARCH);
+    return cache_hash_string(hash, normalized);
+}
+
+static bool run_command(const char* format, ...) {
+    char command[SPEC_COMMAND_LEN];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(command, sizeof(command), format, args);
+    va_end(args);
+    if (length < 0 || (size_t)length >= sizeof(command)) {
+        fprintf(stderr, "Error: Spec build command is too long\n");
+        return false;
+    }
+
+    int status = system(command);
+    if (status != 0) {
+        fprintf(stderr, "Error: Command failed (%d): %s\n", status, command);
+    }
+    return status == 0;
+}
+
+// Сборка <dir>/<хэш>.so и <dir>/<хэш>.spec с нормальной формой. Промежуточные
+// файлы помечены pid, а готовые появляются через rename, поэтому параллельные
+// процессы не видят недособранный файл. Права 0700/0600 не зависят от umask
+static bool build_library(const char* normalized, const char* dir, const char* stem,
+                          const char* library, const char* spec_copy) {
+    char base[SPEC_PATH_LEN];
+    char txt[SPEC_PATH_LEN + 8], asm_path[SPEC_PATH_LEN + 8], obj[SPEC_PATH_LEN + 8], tmp[SPEC_PATH_LEN + 8];
+    snprintf(base, sizeof(base), "%s/%s.%ld", dir, stem, (long)getpid());
+    snprintf(txt, sizeof(txt), "%s.txt", base);
+    snprintf(asm_path, sizeof(asm_path), "%s.asm", base);
+    snprintf(obj, sizeof(obj), "%s.o", base);
+    snprintf(tmp, sizeof(tmp), "%s.so", base);
+
+    int fd = open(txt, O_WRONLY | O_CREAT | O_EXCL, 0600);
+    FILE* out = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!out) {
+        perror(txt);
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    bool written = fputs(normalized, out) >= 0;
+    if (fclose(out) != 0 || !written) {
+        perror(txt);
+        remove(txt);
+        return false;
+    }
+
+    // Вывод инструментов - в stderr: в пакетном режиме stdout занят ответами
+    bool ok = run_command("'%s' '%s' '%s' %s 1>&2", SPEC_GENERATOR, txt, asm_path, SPEC_ARCH)
+        && run_command("nasm -f %s -o '%s' '%s' 1>&2", SPEC_NASM_FORMAT, obj, asm_path)
+        && run_command("%s -shared -o '%s' '%s' 1>&2", SPEC_CC, tmp, obj);
+
+    if (ok && (chmod(tmp, 0700) != 0 || rename(tmp, library) != 0)) {
+        perror(library);
+        ok = false;
+    }
+    if (ok && rename(txt, spec_copy) != 0) {
+        perror(spec_copy);
+        ok = false;
+    }
+
+    remove(txt);
+    remove(asm_path);
+    remove(obj);
+    remove(tmp);
+    return ok;
+}
+
+// Каталог кэша по умолчанию: $XDG_CACHE_HOME/integral-spec или
+// $HOME/.cache/integral-spec. Родительский каталог создается при необходимости
+static bool default_cache_dir(char* out, size_t size) {
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    int length;
+
+    // По спецификации XDG относительный путь в переменной игнорируется
+    if (xdg && xdg[0] == '/') {
+        length = snprintf(out, size, "%s/%s", xdg, SPEC_CACHE_DEFAULT_NAME);
+        if (length < 0 || (size_t)length >= size) return false;
+        if (mkdir(xdg, 0700) != 0 && errno != EEXIST) {
+            perror(xdg);
+            return false;
+        }
+    } else if (home && home[0] == '/') {
+        char parent[SPEC_PATH_LEN];
+        length = snprintf(parent, sizeof(parent), "%s/.cache", home);
+        if (length < 0 || (size_t)length >= sizeof(parent)) return false;
+        if (mkdir(parent, 0700) != 0 && errno != EEXIST) {
+            perror(parent);
+            return false;
+        }
+        length = snprintf(out, size, "%s/%s", parent, SPEC_CACHE_DEFAULT_NAME);
+        if (length < 0 || (size_t)length >= size) return false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Чужой или доступный на запись другим файл может подменить загружаемый
+// код, поэтому каталог кэша и файлы в нем принадлежат текущему
+// пользователю и не доступны на запись группе и остальным
+static bool check_owner(const char* path, const struct stat* st) {
+    if (st->st_uid != getuid() || (st->st_mode & (S_IWGRP | S_IWOTH))) {
+        fprintf(stderr, "Error: %s must be owned by the current user and not writable by others\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool prepare_cache_dir(const char* dir) {
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST) {
+        perror(dir);
+        return false;
+    }
+
+    struct stat st;
+    if (lstat(dir, &st) != 0) {
+        perror(dir);
+        return false;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        fprintf(stderr, "Error: Spec cache %s is not a directory\n", dir);
+        return false;
+    }
+    return check_owner(dir, &st);
+}
+
+// Кэшированная библиотека годится, если это обычный файл владельца, а рядом
+// лежит <хэш>.spec с той же нормальной формой (защита от коллизии хэша
+// и от чужого файла с подходящим именем). Нет файлов - false без сообщения
+static bool cached_library_valid(const char* library, const char* spec_copy, const char* normalized) {
+    struct stat st;
+    if (lstat(library, &st) != 0) {
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        fprintf(stderr, "Error: %s is not a regular file\n", library);
+        return false;
+    }
+    if (!check_owner(library, &st)) {
+        return false;
+    }
+
+    int fd = open(spec_copy, O_RDONLY | O_NOFOLLOW);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || !check_owner(spec_copy, &st)) {
+        close(fd);
+        return false;
+    }
+
+    // Сравнение по частям; лишний хвост файла тоже несовпадение
+    size_t expected = strlen(normalized);
+    size_t used = 0;
+    bool same = true;
+    char chunk[SPEC_MAX_LINE];
+    ssize_t n;
+    while (same && (n = read(fd, chunk, sizeof(chunk))) > 0) {
+        same = used + (size_t)n <= expected && memcmp(chunk, normalized + used, (size_t)n) == 0;
+        used += (size_t)n;
+    }
+    close(fd);
+
+    if (!same || used != expected) {
+        fprintf(stderr, "Warning: %s does not match the spec, rebuilding\n", spec_copy);
+        return false;
+    }
+    return true;
+}
+
+bool spec_load(const char* path, const char* cache_dir, SpecLibrary* spec) {
+    memset(spec, 0, sizeof(*spec));
+
+    char default_dir[SPEC_PATH_LEN];
+    if (!cache_dir) {
+        if (!default_cache_dir(default_dir, sizeof(default_dir))) {
+            fprintf(stderr, "Error: No default spec cache directory (set HOME or use --spec-cache DIR)\n");
+            return false;
+        }
+        cache_dir = default_dir;
+    }
+
+    // Пути подставляются в команды оболочки в одинарных кавычках
+    if (strchr(cache_dir, '\'') || strlen(cache_dir) > SPEC_PATH_LEN - 64) {
+        fprintf(stderr, "Error: Unsupported spec cache directory %s\n", cache_dir);
+        return false;
+    }
+
+    char normalized[4 * SPEC_MAX_LINE + 64];
+    if (!spec_normalize(path, normalized, sizeof(normalized), &spec->a, &spec->b)) {
+        return false;
+    }
+    spec->hash = spec_hash(normalized);
+
+    if (!prepare_cache_dir(cache_dir)) {
+        return false;
+    }
+
+    char stem[17];
+    char library[SPEC_PATH_LEN];
+    char spec_copy[SPEC_PATH_LEN];
+    snprintf(stem, sizeof(stem), "%016llx", (unsigned long long)spec->hash);
+    snprintf(library, sizeof(library), "%s/%s.so", cache_dir, stem);
+    snprintf(spec_copy, sizeof(spec_copy), "%s/%s.spec", cache_dir, stem);
+
+    if (cached_library_valid(library, spec_copy, normalized)) {
+        fprintf(stderr, "Spec %s: cached %s\n", path, library);
+    } else {
+        if (!build_library(normalized, cache_dir, stem, library, spec_copy)) {
+            fprintf(stderr, "Error: Could not build spec %s (is %s built? run make generator)\n",
+                    path, SPEC_GENERATOR);
+            return false;
+        }
+        fprintf(stderr, "Spec %s: built %s\n", path, library);
+    }
+
+    spec->handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+    if (!spec->handle) {
+        fprintf(stderr, "Error: %s\n", dlerror());
+        return false;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        afunc kernels[3];
+        for (int k = 0; k < 3; k++) {
+            // Указатель на функцию из void* - только через memcpy (ISO C)
+            void* symbol = dlsym(spec->handle, symbol_names[i][k]);
+            if (!symbol) {
+                fprintf(stderr, "Error: %s has no symbol %s\n", library, symbol_names[i][k]);
+                spec_unload(spec);
+                return false;
+            }
+            memcpy(&kernels[k], &symbol, sizeof(kernels[k]));
+        }
+
+        snprintf(spec->names[i], SPEC_NAME_LEN, "%s@%s", symbol_names[i][0], stem);
+        spec->curves[i] = create_function_with_ddf(kernels[0], kernels[1], kernels[2], spec->names[i]);
+    }
+
+    return true;
+}
+
+void spec_unload(SpecLibrary* spec) {
+    if (spec->handle) {
+        dlclose(spec->handle);
+        spec->handle = NULL;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef SPEC_H
+#define SPEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../declarations.h"
+
+// Кэш собранных спецификаций кривых (integral --spec FILE).
+// Спецификация нормализуется (отрезок в %.17g, выражения - токены через
+// один пробел), и ключом служит хэш FNV-1a от архитектуры и нормальной
+// формы. В каталоге кэша лежат <хэш>.so и <хэш>.spec с нормальной формой:
+// при промахе они один раз собираются генератором, nasm и cc -shared, дальше
+// только dlopen. Перед загрузкой .spec сравнивается с нормальной формой,
+// а каталог и файлы должны принадлежать пользователю (права 0700).
+// Библиотека экспортирует f1..f3, df1..df3, ddf1..ddf3, как generated_functions.asm
+
+// Каталог по умолчанию - свой у каждого пользователя:
+// $XDG_CACHE_HOME/integral-spec или $HOME/.cache/integral-spec
+#define SPEC_CACHE_DEFAULT_NAME "integral-spec"
+#define SPEC_MAX_LINE 256        // Как буферы выражений в generator.c
+#define SPEC_NAME_LEN 32
+#define SPEC_CACHE_VERSION 1     // Меняется вместе с форматом вывода генератора
+
+// Инструменты сборки, Makefile подставляет свои
+#ifndef SPEC_GENERATOR
+#define SPEC_GENERATOR "./generator"
+#endif
+#ifndef SPEC_ARCH
+#define SPEC_ARCH "i386"
+#endif
+#ifndef SPEC_NASM_FORMAT
+#define SPEC_NASM_FORMAT "elf32"
+#endif
+#ifndef SPEC_CC
+#define SPEC_CC "cc -m32"
+#endif
+
+typedef struct {
+    void* handle;
+    uint64_t hash;
+    double a, b;                          // Отрезок из спецификации
+    char names[3][SPEC_NAME_LEN];         // f1@<хэш>: ключи кэша результатов различают наборы
+    Function curves[3];
+} SpecLibrary;
+
+// Загрузка из кэша или сборка при промахе; false - ошибка (уже напечатана)
+bool spec_load(const char* path, const char* cache_dir, SpecLibrary* spec);
+void spec_unload(SpecLibrary* spec);
+
+// Нормальная форма и ключ, без обращения к кэшу
+bool spec_normalize(const char* path, char* out, size_t size, double* a, double* b);
+uint64_t spec_hash(const char* normalized);
+
+#endif
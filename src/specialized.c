@@ -0,0 +1,99 @@
+#include <stdbool.h>
+#include <math.h>
+
+#include "declarations.h"
+#include "trace/trace.h"
+
+// Специализированные экземпляры составного Симпсона для разностей
+// встроенных кривых (аналог шаблонов). Обобщенный путь на каждый узел
+// идет через evaluate разности, ее ctx_function и еще два evaluate для
+// самих кривых; здесь кривые вызываются напрямую, а цикл по узлам
+// компилируется под конкретную пару. Узлы, порядок суммирования и
+// критерий остановки те же, что в simpson_integrate, поэтому результат
+// совпадает с обобщенным путем
+
+#define DEFINE_SIMPSON_DIFFERENCE(F, G)                                        \
+static double simpson_##F##_minus_##G(double a, double b, double eps) {       \
+    int n = SIMPSON_START_INTERVALS;                                           \
+    double h = (b - a) / n;                                                    \
+    double ends = (F(a) - G(a)) + (F(b) - G(b));                               \
+    double even = 0.0;                                                         \
+    double odd = 0.0;                                                          \
+    for (int i = 1; i < n; i++) {                                              \
+        double x = a + i * h;                                                  \
+        if (i % 2 == 0) {                                                      \
+            even += F(x) - G(x);                                               \
+        } else {                                                               \
+            odd += F(x) - G(x);                                                \
+        }                                                                      \
+    }                                                                          \
+    double result = (ends + 4 * odd + 2 * even) * h / 3.0;                     \
+                                                                               \
+    for (int level = 0; level < SIMPSON_MAX_LEVEL; level++) {                  \
+        even += odd;                                                           \
+        n *= 2;                                                                \
+        h = (b - a) / n;                                                       \
+        odd = 0.0;                                                             \
+        for (int i = 1; i < n; i += 2) {                                       \
+            double x = a + i * h;                                              \
+            odd += F(x) - G(x);                                                \
+        }                                                                      \
+        double previous = result;                                              \
+        result = (ends + 4 * odd + 2 * even) * h / 3.0;                        \
+        if (fabs(result - previous) < eps) {                                   \
+            break;                                                             \
+        }                                                                      \
+    }                                                                          \
+    return result;                                                             \
+}
+
+DEFINE_SIMPSON_DIFFERENCE(f1, f2)
+DEFINE_SIMPSON_DIFFERENCE(f1, f3)
+DEFINE_SIMPSON_DIFFERENCE(f2, f1)
+DEFINE_SIMPSON_DIFFERENCE(f2, f3)
+DEFINE_SIMPSON_DIFFERENCE(f3, f1)
+DEFINE_SIMPSON_DIFFERENCE(f3, f2)
+
+// Таблица диспетчеризации: верхняя и нижняя кривые -> экземпляр
+typedef struct {
+    afunc upper, lower;
+    PairIntegral integrate;
+} SpecializedPair;
+
+static const SpecializedPair simpson_pairs[] = {
+    { f1, f2, simpson_f1_minus_f2 },
+    { f1, f3, simpson_f1_minus_f3 },
+    { f2, f1, simpson_f2_minus_f1 },
+    { f2, f3, simpson_f2_minus_f3 },
+    { f3, f1, simpson_f3_minus_f1 },
+    { f3, f2, simpson_f3_minus_f2 }
+};
+
+// Встроенная кривая: значения берутся прямо из ядра, без контекста
+static bool is_builtin_curve(const Function* f) {
+    return f->function && !f->ctx_function;
+}
+
+// В сборке make profile экземпляры не используются: они не проходят
+// через evaluate, и счетчики вызовов врали бы
+#ifdef ENABLE_PROFILE
+#define SPECIALIZED_ENABLED 0
+#else
+#define SPECIALIZED_ENABLED 1
+#endif
+
+PairIntegral lookup_specialized_simpson(const Integrator* integ, const Function* upper, const Function* lower) {
+    // Трасса записывает уровни Симпсона, их пишет только обобщенный путь
+    if (!SPECIALIZED_ENABLED || trace_buffer || !is_simpson_method(integ) ||
+        !is_builtin_curve(upper) || !is_builtin_curve(lower)) {
+        return NULL;
+    }
+
+    int count = sizeof(simpson_pairs) / sizeof(simpson_pairs[0]);
+    for (int i = 0; i < count; i++) {
+        if (simpson_pairs[i].upper == upper->function && simpson_pairs[i].lower == lower->function) {
+            return simpson_pairs[i].integrate;
+        }
+    }
+    return NULL;
+}
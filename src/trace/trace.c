@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trace.h"
+
+TraceBuffer* trace_buffer = NULL;
+
+static TraceBuffer buffer;
+
+static const char* kind_names[] = { "solver", "simpson" };
+
+// trace_buffer указывает только на buffer, поэтому счетчики берутся
+// прямо из него (через указатель LTO видит возможный NULL и ругается)
+unsigned trace_next_run(void) {
+    return __atomic_add_fetch(&buffer.runs, 1, __ATOMIC_RELAXED);
+}
+
+// Слот занимается атомарно, поэтому потоки пишут в разные записи.
+// Запись может быть испорчена, только если буфер обернулся целиком
+// за время ее заполнения
+void trace_push(TraceKind kind, unsigned run, long step, double x, double value, double width) {
+    unsigned long index = __atomic_fetch_add(&buffer.next, 1, __ATOMIC_RELAXED);
+    TraceRecord* r = &buffer.records[index % buffer.capacity];
+    r->kind = kind;
+    r->run = run;
+    r->step = step;
+    r->x = x;
+    r->value = value;
+    r->width = width;
+}
+
+bool trace_open(const char* path, unsigned long capacity) {
+    if (capacity < 1) capacity = 1;
+
+    buffer.out = fopen(path, "w");
+    if (!buffer.out) {
+        perror(path);
+        return false;
+    }
+
+    buffer.records = (TraceRecord*)malloc(capacity * sizeof(TraceRecord));
+    if (!buffer.records) {
+        fprintf(stderr, "Memory allocation failed for trace buffer\n");
+        exit(EXIT_FAILURE);
+    }
+    buffer.capacity = capacity;
+    buffer.next = 0;
+    buffer.runs = 0;
+
+    trace_buffer = &buffer;
+    return true;
+}
+
+void trace_close(void) {
+    if (!trace_buffer) return;
+    trace_buffer = NULL;
+
+    unsigned long total = buffer.next;
+    unsigned long first = (total > buffer.capacity) ? total - buffer.capacity : 0;
+    if (first > 0) {
+        fprintf(stderr, "Warning: Trace buffer overflowed, %lu oldest records dropped\n", first);
+    }
+
+    fprintf(buffer.out, "kind,run,step,x,value,width\n");
+    for (unsigned long i = first; i < total; i++) {
+        const TraceRecord* r = &buffer.records[i % buffer.capacity];
+        fprintf(buffer.out, "%s,%u,%ld,%.17g,%.17g,%.17g\n", kind_names[r->kind], r->run, r->step,
+                r->x, r->value, r->width);
+    }
+
+    fclose(buffer.out);
+    free(buffer.records);
+    buffer.records = NULL;
+}
@@ -0,0 +1,61 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// Трасса сходимости: каждая итерация решателя (x, f - g, ширина отрезка)
+// и каждое удвоение составного Симпсона (n, оценка, разность с прошлой
+// оценкой, шаг). Записи складываются в кольцевой буфер, выделенный
+// заранее, и пишутся в CSV только в trace_close, так что ввод-вывод не
+// попадает в замеры. При переполнении теряются самые старые записи.
+//
+// CSV: kind,run,step,x,value,width
+//   solver   step - номер итерации, x - приближение, value - f(x) - g(x),
+//            width - ширина текущего отрезка
+//   simpson  step - число интервалов n, x - оценка интеграла, value -
+//            разность с оценкой при n/2, width - шаг h
+// run - номер вызова решателя или интегратора, общий для всех потоков
+
+#define TRACE_DEFAULT_CAPACITY (1 << 16)
+
+typedef enum {
+    TRACE_SOLVER,
+    TRACE_SIMPSON
+} TraceKind;
+
+typedef struct {
+    TraceKind kind;
+    unsigned run;
+    long step;
+    double x;
+    double value;
+    double width;
+} TraceRecord;
+
+typedef struct {
+    TraceRecord* records;
+    unsigned long capacity;
+    unsigned long next;      // Всего записей (атомарно), слот - next % capacity
+    unsigned runs;           // Выданные номера вызовов (атомарно)
+    FILE* out;
+} TraceBuffer;
+
+// NULL - трасса выключена, и макросы ниже стоят одну проверку указателя
+extern TraceBuffer* trace_buffer;
+
+#define TRACE_BEGIN() (trace_buffer ? trace_next_run() : 0u)
+#define TRACE_RECORD(kind, run, step, x, value, width) \
+    do { \
+        if (trace_buffer) trace_push((kind), (run), (step), (x), (value), (width)); \
+    } while (0)
+
+unsigned trace_next_run(void);
+void trace_push(TraceKind kind, unsigned run, long step, double x, double value, double width);
+
+// Открывает файл и выделяет буфер; false, если файл не открылся
+bool trace_open(const char* path, unsigned long capacity);
+// Пишет накопленные записи (от старых к новым) и освобождает буфер
+void trace_close(void);
+
+#endif
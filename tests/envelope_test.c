@@ -0,0 +1,156 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/declarations.h"
+
+// Проверка calculate_envelope_area на 40 кривых против прямого расчета:
+// крайние пересечения ищутся перебором всех пар на мелкой сетке, а площадь
+// между огибающими - составным Симпсоном по max - min без разбиения на куски.
+// Заодно проверяются совпадение результата при разном числе потоков и
+// ошибка при паре с числом пересечений больше ENVELOPE_PAIR_ROOTS
+
+#define TEST_CURVES 40
+#define TEST_A -4.0
+#define TEST_B 2.0
+#define TEST_EPS 1e-7
+#define TEST_TOLERANCE 1e-6
+#define SCAN_CELLS 12000        // Ячейки перебора крайних пересечений
+#define SIMPSON_CELLS 400000    // Ячейки прямого интеграла (четное число)
+
+// A sin(w x + p) + s x + c
+typedef struct {
+    double amplitude, frequency, phase, slope, shift;
+} Wave;
+
+static double wave_value(void* ctx, double x) {
+    const Wave* w = (const Wave*)ctx;
+    return w->amplitude * sin(w->frequency * x + w->phase) + w->slope * x + w->shift;
+}
+
+static double wave_derivative(void* ctx, double x) {
+    const Wave* w = (const Wave*)ctx;
+    return w->amplitude * w->frequency * cos(w->frequency * x + w->phase) + w->slope;
+}
+
+// Детерминированные параметры кривых (линейный конгруэнтный генератор)
+static unsigned long seed = 12345;
+
+static double uniform(double lo, double hi) {
+    seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return lo + (hi - lo) * (double)seed / 2147483648.0;
+}
+
+static double envelope_width(Wave* waves, int n, double x) {
+    double upper = wave_value(&waves[0], x);
+    double lower = upper;
+    for (int i = 1; i < n; i++) {
+        double value = wave_value(&waves[i], x);
+        if (value > upper) upper = value;
+        if (value < lower) lower = value;
+    }
+    return upper - lower;
+}
+
+// Корень разности пары на отрезке со сменой знака
+static double bisect(Wave* f, Wave* g, double lo, double hi) {
+    double h_lo = wave_value(f, lo) - wave_value(g, lo);
+    for (int k = 0; k < 100 && hi - lo > 1e-15; k++) {
+        double mid = (lo + hi) / 2;
+        double h_mid = wave_value(f, mid) - wave_value(g, mid);
+        if ((h_mid < 0.0) == (h_lo < 0.0)) {
+            lo = mid;
+            h_lo = h_mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo + hi) / 2;
+}
+
+static double brute_force_area(Wave* waves, int n) {
+    static double samples[TEST_CURVES][SCAN_CELLS + 1];
+    double h = (TEST_B - TEST_A) / SCAN_CELLS;
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k <= SCAN_CELLS; k++) {
+            samples[i][k] = wave_value(&waves[i], TEST_A + k * h);
+        }
+    }
+
+    // Крайние пересечения по всем парам
+    double left = TEST_B;
+    double right = TEST_A;
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            for (int k = 1; k <= SCAN_CELLS; k++) {
+                if ((samples[i][k - 1] - samples[j][k - 1] < 0.0) != (samples[i][k] - samples[j][k] < 0.0)) {
+                    left = fmin(left, bisect(&waves[i], &waves[j], TEST_A + (k - 1) * h, TEST_A + k * h));
+                    break;
+                }
+            }
+            for (int k = SCAN_CELLS; k >= 1; k--) {
+                if ((samples[i][k - 1] - samples[j][k - 1] < 0.0) != (samples[i][k] - samples[j][k] < 0.0)) {
+                    right = fmax(right, bisect(&waves[i], &waves[j], TEST_A + (k - 1) * h, TEST_A + k * h));
+                    break;
+                }
+            }
+        }
+    }
+    if (!(right > left)) {
+        return -1.0;
+    }
+
+    // Составной Симпсон по max - min: изломы огибающих дают ошибку O(h^2)
+    double step = (right - left) / SIMPSON_CELLS;
+    double sum = envelope_width(waves, n, left) + envelope_width(waves, n, right);
+    for (int k = 1; k < SIMPSON_CELLS; k++) {
+        sum += ((k % 2) ? 4.0 : 2.0) * envelope_width(waves, n, left + k * step);
+    }
+    return sum * step / 3.0;
+}
+
+int main(void) {
+    static Wave waves[TEST_CURVES];
+    static Function curves[TEST_CURVES];
+    for (int i = 0; i < TEST_CURVES; i++) {
+        waves[i].amplitude = uniform(0.2, 1.5);
+        waves[i].frequency = uniform(0.3, 2.0);
+        waves[i].phase = uniform(0.0, 6.283185307179586);
+        waves[i].slope = uniform(-0.5, 0.5);
+        waves[i].shift = uniform(-1.0, 1.0);
+        curves[i] = create_context_function(wave_value, wave_derivative, &waves[i], "wave");
+    }
+
+    RootFinder rf = create_combined_method();
+    Integrator integ = create_simpson_method();
+    int failures = 0;
+
+    double expected = brute_force_area(waves, TEST_CURVES);
+    double single = calculate_envelope_area(curves, TEST_CURVES, TEST_A, TEST_B, TEST_EPS, &rf, &integ, 1);
+    double threaded = calculate_envelope_area(curves, TEST_CURVES, TEST_A, TEST_B, TEST_EPS, &rf, &integ, 4);
+    printf("%d curves: envelope %.12f, brute force %.12f, difference %.3g\n", TEST_CURVES, single, expected,
+           fabs(single - expected));
+
+    if (!(expected > 0) || !(fabs(single - expected) < TEST_TOLERANCE)) {
+        fprintf(stderr, "FAIL: envelope area differs from the brute-force integral\n");
+        failures++;
+    }
+    if (memcmp(&single, &threaded, sizeof(single)) != 0) {
+        fprintf(stderr, "FAIL: envelope area depends on the thread count (%.17g vs %.17g)\n", single, threaded);
+        failures++;
+    }
+
+    // sin(40 x) и ноль пересекаются на [-4, 2] около 76 раз
+    Wave dense[2] = { { 1.0, 40.0, 0.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0, 0.0, 0.0 } };
+    Function pair[2] = {
+        create_context_function(wave_value, wave_derivative, &dense[0], "sin40"),
+        create_context_function(wave_value, wave_derivative, &dense[1], "zero")
+    };
+    if (calculate_envelope_area(pair, 2, TEST_A, TEST_B, TEST_EPS, &rf, &integ, 1) >= 0) {
+        fprintf(stderr, "FAIL: more than %d crossings of one pair were not reported\n", ENVELOPE_PAIR_ROOTS);
+        failures++;
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -9,7 +9,9 @@ static double test_x2(double x) { return x * x; }
 static double test_2x(double x) { return 2 * x; }
 static double test_exp(double x) { return exp(x); }
 
-void test_root(RootFinder* rf, int f1_idx, int f2_idx, double a, double b, double eps, double expected) {
+void test_root(struct ResultCache* cache, RootFinder* rf, int f1_idx, int f2_idx, double a, double b, double eps,
+               double expected) {
+    (void)cache;
     Function test_funcs[] = {
         create_function(test_sin, test_cos, "sin"),
         create_function(test_x2, test_2x, "x^2"),
@@ -24,7 +26,9 @@ void test_root(RootFinder* rf, int f1_idx, int f2_idx, double a, double b, doubl
     printf("Result: %.6f, Abs Error: %.6f, Rel Error: %.6f\n", result, abs_error, rel_error);
 }
 
-void test_integral(Integrator* integ, int f_idx, double a, double b, double eps, double expected) {
+void test_integral(struct ResultCache* cache, Integrator* integ, int f_idx, double a, double b, double eps,
+                   double expected) {
+    (void)cache;
     Function test_funcs[] = {
         create_function(test_sin, test_cos, "sin"),
         create_function(test_x2, test_2x, "x^2"),
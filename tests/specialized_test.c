@@ -0,0 +1,64 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/declarations.h"
+
+// Специализированные экземпляры Симпсона против обобщенного пути: для каждой
+// упорядоченной пары встроенных кривых, нескольких отрезков и точностей
+// интегралы должны совпадать (узлы, порядок суммирования и остановка те же).
+// Допуск - на случай разного округления промежуточных значений (x87, FMA)
+
+#define TEST_TOLERANCE 1e-12
+
+typedef struct {
+    double a, b;
+} Segment;
+
+static const Segment segments[] = { { 0.0, 2.0 }, { -4.0, 2.0 }, { 0.650520, 1.279353 }, { -2.522205, 0.650520 } };
+static const double tolerances[] = { 1e-3, 1e-6, 1e-9 };
+
+int main(void) {
+    Function curves[3];
+    for (int i = 0; i < 3; i++) {
+        lookup_curve(i + 1, &curves[i]);
+    }
+
+    Integrator integ = create_simpson_method();
+    int failures = 0;
+    int checks = 0;
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if (i == j) continue;
+
+            FunctionPair pair = { &curves[i], &curves[j] };
+            PairIntegral special = lookup_specialized_simpson(&integ, pair.upper, pair.lower);
+            if (!special) {
+                // make profile вырезает экземпляры: сравнивать не с чем
+                printf("f%d - f%d: no specialized instance in this build\n", i + 1, j + 1);
+                continue;
+            }
+
+            Function diff = create_difference_function(&pair);
+            for (size_t s = 0; s < sizeof(segments) / sizeof(segments[0]); s++) {
+                for (size_t t = 0; t < sizeof(tolerances) / sizeof(tolerances[0]); t++) {
+                    double a = segments[s].a;
+                    double b = segments[s].b;
+                    double expected = integ.integrate(&diff, a, b, tolerances[t]);
+                    double actual = special(a, b, tolerances[t]);
+                    checks++;
+
+                    if (!(fabs(actual - expected) <= TEST_TOLERANCE * fmax(1.0, fabs(expected)))) {
+                        fprintf(stderr, "FAIL: f%d - f%d on [%g, %g], eps %g: specialized %.17g, generic %.17g\n",
+                                i + 1, j + 1, a, b, tolerances[t], actual, expected);
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%d specialized Simpson checks, %d failures\n", checks, failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+#include <math.h>
+
+#include "../src/plugin/plugin_abi.h"
+
+// Пример плагина кривых: cc -fPIC -shared -o example_plugin.so example_plugin.c -lm
+// Кривые получают номера 4, 5, 6 (при первом --plugin), например задание
+// "4 5 6 -1 1 0.0001" в пакетном режиме
+
+// p(x) = x^2 - 1
+static double parabola(double x) {
+    return x * x - 1.0;
+}
+
+static double parabola_derivative(double x) {
+    return 2.0 * x;
+}
+
+static double parabola_second_derivative(double x) {
+    (void)x;
+    return 2.0;
+}
+
+// Пакетная версия: цикл без вызовов через указатель векторизуется
+static void parabola_batch(const double* x, double* y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] = x[i] * x[i] - 1.0;
+    }
+}
+
+// c(x) = cos(x)
+static double cosine(double x) {
+    return cos(x);
+}
+
+static double cosine_derivative(double x) {
+    return -sin(x);
+}
+
+static double cosine_second_derivative(double x) {
+    return -cos(x);
+}
+
+// l(x) = x / 2 (вторая производная не задана - Галлей ее не получит)
+static double line(double x) {
+    return 0.5 * x;
+}
+
+static double line_derivative(double x) {
+    (void)x;
+    return 0.5;
+}
+
+static const IntegralPluginCurve curves[] = {
+    { "parabola", parabola, parabola_derivative, parabola_second_derivative, parabola_batch },
+    { "cosine", cosine, cosine_derivative, cosine_second_derivative, NULL },
+    { "line", line, line_derivative, NULL, NULL }
+};
+
+const IntegralPluginDescriptor integral_plugin = {
+    INTEGRAL_PLUGIN_ABI_VERSION,
+    sizeof(curves) / sizeof(curves[0]),
+    curves
+};
@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "../src/server/server.h"
+
+// Клиент серверного режима (integral --serve PATH):
+//
+//   server_client PATH area F1 F2 F3 A B EPS
+//   server_client PATH roots F1 F2 F3 A B EPS
+//   server_client PATH integral F A B EPS
+//   server_client PATH stats
+//   server_client PATH shutdown
+//   server_client PATH idle MS     - запрос stats, затем MS миллисекунд
+//                                    простоя на открытом соединении
+//
+// Ответ печатается в stdout; код возврата 0 только при статусе SERVER_OK
+
+static int connect_socket(const char* path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Error: Socket path is too long: %s\n", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int transfer(int fd, void* buffer, size_t size, int sending) {
+    unsigned char* p = (unsigned char*)buffer;
+    while (size > 0) {
+        ssize_t n = sending ? send(fd, p, size, MSG_NOSIGNAL) : recv(fd, p, size, 0);
+        if (n <= 0) return 0;
+        p += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+// Поля запроса: номера кривых (int32) и числа (double) по порядку
+static uint32_t pack(unsigned char* out, char** args, int ints, int doubles) {
+    uint32_t length = 0;
+    for (int i = 0; i < ints; i++) {
+        int32_t id = (int32_t)atoi(args[i]);
+        memcpy(out + length, &id, sizeof(id));
+        length += sizeof(id);
+    }
+    for (int i = 0; i < doubles; i++) {
+        double x = atof(args[ints + i]);
+        memcpy(out + length, &x, sizeof(x));
+        length += sizeof(x);
+    }
+    return length;
+}
+
+static void usage(void) {
+    fprintf(stderr, "Usage: server_client PATH area|roots F1 F2 F3 A B EPS | integral F A B EPS | "
+                    "stats | shutdown | idle MS\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const char* command = argv[2];
+    uint32_t header[2] = { 0, 0 };
+    unsigned char body[SERVER_MAX_PAYLOAD];
+    long idle_ms = 0;
+
+    if ((strcmp(command, "area") == 0 || strcmp(command, "roots") == 0) && argc == 9) {
+        header[0] = command[0] == 'a' ? SERVER_AREA : SERVER_ROOTS;
+        header[1] = pack(body, argv + 3, 3, 3);
+    } else if (strcmp(command, "integral") == 0 && argc == 7) {
+        header[0] = SERVER_INTEGRAL;
+        header[1] = pack(body, argv + 3, 1, 3);
+    } else if (strcmp(command, "stats") == 0 && argc == 3) {
+        header[0] = SERVER_STATS;
+    } else if (strcmp(command, "shutdown") == 0 && argc == 3) {
+        header[0] = SERVER_SHUTDOWN;
+    } else if (strcmp(command, "idle") == 0 && argc == 4) {
+        header[0] = SERVER_STATS;
+        idle_ms = atol(argv[3]);
+    } else {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    int fd = connect_socket(argv[1]);
+    if (fd < 0) return EXIT_FAILURE;
+
+    uint32_t response[2];
+    unsigned char out[SERVER_MAX_PAYLOAD];
+    if (!transfer(fd, header, sizeof(header), 1) || !transfer(fd, body, header[1], 1) ||
+        !transfer(fd, response, sizeof(response), 0) || response[1] > SERVER_MAX_PAYLOAD ||
+        !transfer(fd, out, response[1], 0)) {
+        fprintf(stderr, "Error: Connection to %s failed\n", argv[1]);
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    if (response[0] != SERVER_OK) {
+        fprintf(stderr, "Error: Server status %u\n", (unsigned)response[0]);
+    } else if (header[0] == SERVER_AREA || header[0] == SERVER_INTEGRAL) {
+        double value;
+        memcpy(&value, out, sizeof(value));
+        printf("%.10f\n", value);
+    } else if (header[0] == SERVER_ROOTS) {
+        int32_t count;
+        memcpy(&count, out, sizeof(count));
+        for (int32_t i = 0; i < count; i++) {
+            double x;
+            memcpy(&x, out + sizeof(count) + i * sizeof(x), sizeof(x));
+            printf("%.10f\n", x);
+        }
+    } else if (header[0] == SERVER_STATS && idle_ms == 0) {
+        uint64_t requests, errors, hits, misses;
+        double p50, p99;
+        memcpy(&requests, out, 8);
+        memcpy(&errors, out + 8, 8);
+        memcpy(&p50, out + 16, 8);
+        memcpy(&p99, out + 24, 8);
+        memcpy(&hits, out + 32, 8);
+        memcpy(&misses, out + 40, 8);
+        printf("requests %llu errors %llu p50 %.1f us p99 %.1f us cache %llu hits %llu misses\n",
+               (unsigned long long)requests, (unsigned long long)errors, p50, p99,
+               (unsigned long long)hits, (unsigned long long)misses);
+    }
+
+    if (idle_ms > 0) {
+        usleep((useconds_t)(idle_ms * 1000));
+    }
+
+    close(fd);
+    return response[0] == SERVER_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Сводка по трассе сходимости (integral --trace FILE).
+// Для каждого вызова решателя - число итераций, последняя |f - g| и
+// наблюдаемый порядок сходимости p = ln(e[k+1]/e[k]) / ln(e[k]/e[k-1])
+// по трем последним невырожденным невязкам (1 - линейная, 2 - Ньютон,
+// 3 - Галлей). Для Симпсона - число удвоений, последняя разность оценок
+// и отношение соседних разностей (16 для метода четвертого порядка).
+// Итог по видам - медианы по вызовам
+
+#define LINE_LEN 256
+
+typedef struct {
+    int simpson;        // 0 - решатель, 1 - Симпсон
+    unsigned run;
+    long step;
+    double value;
+} Record;
+
+static int compare_records(const void* x, const void* y) {
+    const Record* a = (const Record*)x;
+    const Record* b = (const Record*)y;
+    if (a->run != b->run) return (a->run > b->run) - (a->run < b->run);
+    return (a->step > b->step) - (a->step < b->step);
+}
+
+static int compare_doubles(const void* x, const void* y) {
+    double a = *(const double*)x;
+    double b = *(const double*)y;
+    return (a > b) - (a < b);
+}
+
+static double median(double* values, int n) {
+    if (n == 0) return NAN;
+    qsort(values, (size_t)n, sizeof(double), compare_doubles);
+    return (n % 2) ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+// Порядок по последним трем невязкам, NAN если их не набралось
+static double observed_order(const Record* r, int n) {
+    double e[3];
+    int found = 0;
+    for (int i = n - 1; i >= 0 && found < 3; i--) {
+        double v = fabs(r[i].value);
+        if (v > 0 && (found == 0 || v > e[found - 1])) {
+            e[found++] = v;
+        }
+    }
+    if (found < 3) return NAN;
+
+    // e[0] - последняя, e[2] - самая ранняя из трех
+    double denominator = log(e[1] / e[2]);
+    return (fabs(denominator) > 0) ? log(e[0] / e[1]) / denominator : NAN;
+}
+
+// Отношение двух последних разностей оценок Симпсона
+static double delta_ratio(const Record* r, int n) {
+    if (n < 2) return NAN;
+    double last = fabs(r[n - 1].value);
+    double before = fabs(r[n - 2].value);
+    return (last > 0) ? before / last : NAN;
+}
+
+static Record* read_records(FILE* in, int* count) {
+    int capacity = 1024;
+    Record* records = (Record*)malloc(capacity * sizeof(Record));
+    char line[LINE_LEN];
+    *count = 0;
+
+    while (records && fgets(line, sizeof(line), in)) {
+        char kind[16];
+        Record r;
+        double x, width;
+        if (sscanf(line, "%15[^,],%u,%ld,%lf,%lf,%lf", kind, &r.run, &r.step, &x, &r.value, &width) != 6) {
+            continue;  // Заголовок и поврежденные строки
+        }
+        r.simpson = (strcmp(kind, "simpson") == 0);
+
+        if (*count == capacity) {
+            capacity *= 2;
+            Record* grown = (Record*)realloc(records, capacity * sizeof(Record));
+            if (!grown) {
+                free(records);
+                return NULL;
+            }
+            records = grown;
+        }
+        records[(*count)++] = r;
+    }
+
+    return records;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s TRACE.csv\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* in = (strcmp(argv[1], "-") == 0) ? stdin : fopen(argv[1], "r");
+    if (!in) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    int count = 0;
+    Record* records = read_records(in, &count);
+    if (in != stdin) fclose(in);
+    if (!records) {
+        fprintf(stderr, "Memory allocation failed for trace records\n");
+        return EXIT_FAILURE;
+    }
+
+    qsort(records, (size_t)count, sizeof(Record), compare_records);
+
+    // Метрики по вызовам для медиан: [0] - решатели, [1] - Симпсон
+    double* steps[2] = { malloc(count * sizeof(double) + 1), malloc(count * sizeof(double) + 1) };
+    double* rates[2] = { malloc(count * sizeof(double) + 1), malloc(count * sizeof(double) + 1) };
+    int runs[2] = { 0, 0 };
+    int rated[2] = { 0, 0 };
+    if (!steps[0] || !steps[1] || !rates[0] || !rates[1]) {
+        fprintf(stderr, "Memory allocation failed for trace summary\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-8s %6s %6s %14s %10s\n", "kind", "run", "steps", "last", "rate");
+    for (int start = 0; start < count;) {
+        int end = start;
+        while (end < count && records[end].run == records[start].run) end++;
+
+        const Record* r = &records[start];
+        int n = end - start;
+        int k = r->simpson;
+        double rate = k ? delta_ratio(r, n) : observed_order(r, n);
+
+        printf("%-8s %6u %6d %14.6e %10.3f\n", k ? "simpson" : "solver", r->run, n, fabs(r[n - 1].value), rate);
+
+        steps[k][runs[k]++] = n;
+        if (!isnan(rate)) rates[k][rated[k]++] = rate;
+        start = end;
+    }
+
+    printf("\nsolver:  %d runs, median %.1f iterations, median order %.3f\n",
+           runs[0], median(steps[0], runs[0]), median(rates[0], rated[0]));
+    printf("simpson: %d runs, median %.1f levels, median delta ratio %.3f (order %.3f)\n",
+           runs[1], median(steps[1], runs[1]), median(rates[1], rated[1]), log2(median(rates[1], rated[1])));
+
+    for (int k = 0; k < 2; k++) {
+        free(steps[k]);
+        free(rates[k]);
+    }
+    free(records);
+    return EXIT_SUCCESS;
+}